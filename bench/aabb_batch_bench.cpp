@@ -0,0 +1,70 @@
+// aabb_batch_bench.cpp
+// Compares the batch overlap kernel with a plain Hitbox::isColliding loop.
+// Not part of the game build, compile it on its own from the repository root, e.g.
+//   g++ -std=c++17 -O2 -march=native -Idependencies/include -Isrc bench/aabb_batch_bench.cpp src/BoxBatch.cpp src/hitbox.cpp -o aabb_bench
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "BoxBatch.h"
+#include "hitbox.hpp"
+
+// Run fn enough times to take a measurable amount of time, returns nanoseconds per box
+template <typename Fn>
+static double timePerBox(size_t boxCount, Fn&& fn) {
+    size_t repeats = 1;
+    while (true) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t r = 0; r < repeats; r++) fn();
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        if (seconds > 0.2) return seconds * 1e9 / (double(repeats) * boxCount);
+        repeats *= 2;
+    }
+}
+
+int main() {
+    std::mt19937 generator(1234);
+    std::uniform_real_distribution<float> coordinate(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> size(0.5f, 5.0f);
+
+    std::printf("Batch kernel: %s\n", overlapBatchPath());
+    std::printf("%10s %14s %14s %9s %8s\n", "boxes", "scalar ns/box", "batch ns/box", "speedup", "hits");
+
+    for (size_t boxCount : {size_t(100), size_t(10000), size_t(1000000)}) {
+        // The same random boxes as an array of Hitbox and as separate arrays
+        std::vector<Hitbox> boxes;
+        BoxBatch batch;
+        boxes.reserve(boxCount);
+        batch.reserve(boxCount);
+        for (size_t i = 0; i < boxCount; i++) {
+            glm::vec3 minCorner(coordinate(generator), coordinate(generator) * 0.01f, coordinate(generator));
+            Hitbox box(minCorner, minCorner + glm::vec3(size(generator), size(generator), size(generator)));
+            boxes.push_back(box);
+            batch.add(box);
+        }
+
+        Hitbox query(glm::vec3(-100.0f, -10.0f, -100.0f), glm::vec3(100.0f, 10.0f, 100.0f));
+        std::vector<uint32_t> results(boxCount);
+        size_t scalarHits = 0;
+        size_t batchHits = 0;
+
+        double scalarTime = timePerBox(boxCount, [&]() {
+            size_t found = 0;
+            for (size_t i = 0; i < boxes.size(); i++) {
+                if (query.isColliding(boxes[i])) results[found++] = static_cast<uint32_t>(i);
+            }
+            scalarHits = found;
+        });
+        double batchTime = timePerBox(boxCount, [&]() {
+            batchHits = overlapBatch(query, batch.columns(), boxCount, results.data());
+        });
+
+        if (scalarHits != batchHits) {
+            std::printf("Hit count mismatch at %zu boxes: %zu vs %zu\n", boxCount, scalarHits, batchHits);
+            return 1;
+        }
+        std::printf("%10zu %14.3f %14.3f %8.2fx %8zu\n", boxCount, scalarTime, batchTime, scalarTime / batchTime, batchHits);
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include "AgentActivity.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+void AgentActivity::reserve(size_t count) {
+    awakeList.reserve(count);
+    sleepingList.reserve(count);
+    listPosition.reserve(count);
+    inSleepingList.reserve(count);
+    sleepTicks.reserve(count);
+    wakeTicks.reserve(count);
+    timers.reserve(count * 2);  // Room for a stale entry per agent as well
+}
+
+void AgentActivity::reset(size_t count) {
+    reserve(count);
+    awakeList.resize(count);
+    listPosition.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        awakeList[i] = static_cast<uint32_t>(i);
+        listPosition[i] = static_cast<uint32_t>(i);
+    }
+    sleepingList.clear();
+    inSleepingList.assign(count, 0);
+    sleepTicks.assign(count, 0);
+    wakeTicks.assign(count, NO_TIMER);
+    timers.clear();
+    version++;
+}
+
+void AgentActivity::add(uint32_t index) {
+    if (listPosition.size() <= index) {
+        listPosition.resize(index + 1);
+        inSleepingList.resize(index + 1, 0);
+        sleepTicks.resize(index + 1, 0);
+        wakeTicks.resize(index + 1, NO_TIMER);
+    }
+    listPosition[index] = static_cast<uint32_t>(awakeList.size());
+    awakeList.push_back(index);
+}
+
+// Swap-remove the entry at 'position' of a list, keeping the moved agent's position current
+static void removeAt(std::vector<uint32_t>& list, std::vector<uint32_t>& listPosition, uint32_t position) {
+    uint32_t moved = list.back();
+    list[position] = moved;
+    listPosition[moved] = position;
+    list.pop_back();
+}
+
+void AgentActivity::beginTick(AgentStore& agents, uint32_t tick, float deltaTime) {
+    // Timers running out this tick, the agent then runs this tick's update as usual
+    while (!timers.empty() && timers.front().first <= tick) {
+        std::pop_heap(timers.begin(), timers.end(), std::greater<Timer>());
+        Timer timer = timers.back();
+        timers.pop_back();
+        uint32_t index = timer.second;
+        if (inSleepingList[index] && wakeTicks[index] == timer.first) {
+            wake(agents, index, tick - 1, deltaTime);
+        }
+    }
+
+    // Agents that fell asleep last tick still moved then, so save their transforms once more
+    // before dropping them. Sleeping agents then render exactly where they stopped.
+    agents.savePreviousState(awakeList);
+
+    for (uint32_t position = 0; position < awakeList.size();) {
+        uint32_t index = awakeList[position];
+        if (!(agents.flags[index] & AGENT_SLEEPING)) {
+            position++;
+            continue;
+        }
+        removeAt(awakeList, listPosition, position);
+        listPosition[index] = static_cast<uint32_t>(sleepingList.size());
+        sleepingList.push_back(index);
+        inSleepingList[index] = 1;
+        if (wakeTicks[index] != NO_TIMER) {
+            timers.push_back(Timer(wakeTicks[index], index));
+            std::push_heap(timers.begin(), timers.end(), std::greater<Timer>());
+        }
+        version++;
+    }
+}
+
+void AgentActivity::sleep(AgentStore& agents, uint32_t index, uint32_t tick, uint32_t wakeTick) {
+    agents.flags[index] |= AGENT_SLEEPING;
+    sleepTicks[index] = tick;
+    wakeTicks[index] = wakeTick;
+}
+
+void AgentActivity::wake(AgentStore& agents, uint32_t index, uint32_t tick, float deltaTime) {
+    if (!(agents.flags[index] & AGENT_SLEEPING)) return;
+    agents.flags[index] &= ~AGENT_SLEEPING;
+
+    // Count the skipped ticks as waited, so the stop timer ends when it would have anyway
+    agents.timeStopped[index] += static_cast<float>(tick - sleepTicks[index]) * deltaTime;
+
+    // Not dropped yet if it fell asleep on the tick it is woken on
+    if (!inSleepingList[index]) return;
+    removeAt(sleepingList, listPosition, listPosition[index]);
+    inSleepingList[index] = 0;
+    listPosition[index] = static_cast<uint32_t>(awakeList.size());
+    awakeList.push_back(index);
+    version++;
+}
+
+uint32_t AgentActivity::ticksUntil(float remaining, float deltaTime) {
+    if (remaining <= 0.0f) return 0;
+    return static_cast<uint32_t>(std::ceil(remaining / deltaTime));
+}
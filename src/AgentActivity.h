@@ -0,0 +1,60 @@
+// AgentActivity.h
+// Tracks which agents of a system are awake. An agent with no velocity that is only
+// waiting out a timer is put to sleep: it leaves the awake list, so the updates and the
+// per-tick broadphase skip it, and it wakes when its timer runs out or when it is hit.
+
+#ifndef AGENT_ACTIVITY_H
+#define AGENT_ACTIVITY_H
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "EntityStore.h"
+
+// Agents are tracked by dense index, so they must not be removed from the store during a round
+class AgentActivity {
+public:
+    static constexpr uint32_t NO_TIMER = UINT32_MAX;  // Sleep until something hits the agent
+
+    // Every one of 'count' agents awake
+    void reset(size_t count);
+    // Make room for 'count' agents, so sleeping and waking never allocate
+    void reserve(size_t count);
+    // A newly spawned agent, awake
+    void add(uint32_t index);
+
+    // Start of a tick: wake the agents whose timer ends on 'tick', save the previous
+    // transforms of the awake agents, then drop the ones that fell asleep last tick
+    void beginTick(AgentStore& agents, uint32_t tick, float deltaTime);
+
+    // Put an agent to sleep at the end of 'tick' until 'wakeTick'. Only writes that agent's
+    // entries, so the worker updating the agent may call it. It leaves the awake list next tick.
+    void sleep(AgentStore& agents, uint32_t index, uint32_t tick, uint32_t wakeTick);
+    // Wake an agent whose last skipped tick was 'tick', e.g. when it is hit
+    void wake(AgentStore& agents, uint32_t index, uint32_t tick, float deltaTime);
+
+    // Ticks of 'deltaTime' until a timer with 'remaining' seconds left runs out
+    static uint32_t ticksUntil(float remaining, float deltaTime);
+
+    const std::vector<uint32_t>& awake() const { return awakeList; }
+    const std::vector<uint32_t>& sleeping() const { return sleepingList; }
+    // Changes whenever the sleeping list does, so a grid of sleeping agents knows to rebuild
+    uint64_t sleepingVersion() const { return version; }
+
+private:
+    std::vector<uint32_t> awakeList;
+    std::vector<uint32_t> sleepingList;
+    std::vector<uint32_t> listPosition;   // Index of every agent in its list
+    std::vector<uint8_t> inSleepingList;
+    std::vector<uint32_t> sleepTicks;     // Tick every sleeping agent fell asleep on
+    std::vector<uint32_t> wakeTicks;      // Tick its timer runs out on
+    uint64_t version = 0;
+
+    // Min-heap of (wakeTick, index). Entries of agents that woke early are skipped when popped.
+    // A plain vector so reset() can reserve it and a running game does not allocate.
+    using Timer = std::pair<uint32_t, uint32_t>;
+    std::vector<Timer> timers;
+};
+
+#endif // AGENT_ACTIVITY_H
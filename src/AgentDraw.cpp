@@ -0,0 +1,18 @@
+#include "AgentDraw.h"
+#include <glm/gtc/matrix_transform.hpp> // For rotation
+
+void drawAgents(const AgentTransforms& snapshot, Shader& shader, Model& model, const glm::mat4& view,
+                const glm::mat4& projection, float alpha, float scale) {
+    shader.setMat4("view", view);
+    shader.setMat4("projection", projection);
+
+    for (size_t i = 0; i < snapshot.size(); i++) {
+        glm::mat4 modelMatrix = glm::mat4(1.0f);
+        modelMatrix = glm::translate(modelMatrix, snapshot.position(i, alpha));
+        modelMatrix = glm::rotate(modelMatrix, glm::radians(snapshot.heading(i, alpha)), glm::vec3(0.0f, 1.0f, 0.0f));
+        modelMatrix = glm::scale(modelMatrix, glm::vec3(scale));
+
+        shader.setMat4("model", modelMatrix);
+        model.draw(shader);
+    }
+}
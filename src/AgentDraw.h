@@ -0,0 +1,18 @@
+// AgentDraw.h
+// Drawing shared by the cow and giraffe systems: one model per agent of a published
+// transform snapshot.
+
+#ifndef AGENT_DRAW_H
+#define AGENT_DRAW_H
+
+#include <glm/glm.hpp>
+#include "TransformSnapshot.h"
+#include "model.hpp"
+#include "shader.h"
+
+// Draw every agent in 'snapshot' blended 'alpha' of the way from the previous to the current
+// tick, with the model scaled by 'scale'
+void drawAgents(const AgentTransforms& snapshot, Shader& shader, Model& model, const glm::mat4& view,
+                const glm::mat4& projection, float alpha, float scale);
+
+#endif // AGENT_DRAW_H
@@ -0,0 +1,108 @@
+#include "AllocationTracker.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global operator new and delete. Nothing in here may allocate itself.
+
+static std::atomic<uint64_t> allocationCount{0};
+static std::atomic<uint64_t> allocationBytes{0};
+static std::atomic<bool> checking{false};
+static thread_local bool forbidden = false;
+
+AllocationStats allocationStats() {
+    AllocationStats stats;
+    stats.count = allocationCount.load(std::memory_order_relaxed);
+    stats.bytes = allocationBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void setAllocationChecking(bool enabled) {
+    checking.store(enabled, std::memory_order_relaxed);
+}
+
+bool allocationCheckingEnabled() {
+    return checking.load(std::memory_order_relaxed);
+}
+
+bool allocationsForbidden() {
+    return forbidden;
+}
+
+NoAllocationScope::NoAllocationScope(bool active) : previous(forbidden) {
+    if (active) forbidden = true;
+}
+
+NoAllocationScope::~NoAllocationScope() {
+    forbidden = previous;
+}
+
+AllowAllocationScope::AllowAllocationScope() : previous(forbidden) {
+    forbidden = false;
+}
+
+AllowAllocationScope::~AllowAllocationScope() {
+    forbidden = previous;
+}
+
+static void countAllocation(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+
+    if (forbidden && checking.load(std::memory_order_relaxed)) {
+        // stdio with a fixed message, the usual streams could allocate again
+        std::fprintf(stderr, "Heap allocation of %zu bytes inside a NoAllocationScope\n", size);
+        std::abort();
+    }
+}
+
+static void* allocate(size_t size) {
+    countAllocation(size);
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+static void* allocateAligned(size_t size, size_t alignment) {
+    countAllocation(size);
+    // aligned_alloc wants the size to be a multiple of the alignment
+    size_t rounded = (size + alignment - 1) / alignment * alignment;
+#if defined(_WIN32)
+    void* memory = _aligned_malloc(rounded == 0 ? alignment : rounded, alignment);
+#else
+    void* memory = std::aligned_alloc(alignment, rounded == 0 ? alignment : rounded);
+#endif
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+static void releaseAligned(void* memory) {
+#if defined(_WIN32)
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new(size_t size, std::align_val_t alignment) { return allocateAligned(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return allocateAligned(size, static_cast<size_t>(alignment)); }
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { releaseAligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { releaseAligned(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { releaseAligned(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { releaseAligned(memory); }
@@ -0,0 +1,50 @@
+// AllocationTracker.h
+// Counts every heap allocation made through operator new, on every thread. Code that must
+// not allocate, like the in-game loop once it has warmed up, runs inside a NoAllocationScope;
+// with checking turned on an allocation inside one prints a message and aborts.
+
+#ifndef ALLOCATION_TRACKER_H
+#define ALLOCATION_TRACKER_H
+
+#include <cstdint>
+
+struct AllocationStats {
+    uint64_t count = 0;  // Allocations so far
+    uint64_t bytes = 0;  // Bytes requested by them
+};
+
+// Totals over all threads since the program started
+AllocationStats allocationStats();
+
+// Abort on allocations inside a NoAllocationScope (off by default, scopes then only mark code)
+void setAllocationChecking(bool enabled);
+bool allocationCheckingEnabled();
+
+// Whether the calling thread is inside an active NoAllocationScope
+bool allocationsForbidden();
+
+// Forbids allocations on the calling thread while it lives, pass false to leave things as they are
+class NoAllocationScope {
+public:
+    explicit NoAllocationScope(bool active = true);
+    ~NoAllocationScope();
+    NoAllocationScope(const NoAllocationScope&) = delete;
+    NoAllocationScope& operator=(const NoAllocationScope&) = delete;
+
+private:
+    bool previous;
+};
+
+// Allows allocations again inside a NoAllocationScope, e.g. around a debug report
+class AllowAllocationScope {
+public:
+    AllowAllocationScope();
+    ~AllowAllocationScope();
+    AllowAllocationScope(const AllowAllocationScope&) = delete;
+    AllowAllocationScope& operator=(const AllowAllocationScope&) = delete;
+
+private:
+    bool previous;
+};
+
+#endif // ALLOCATION_TRACKER_H
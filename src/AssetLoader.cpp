@@ -0,0 +1,178 @@
+#include "AssetLoader.h"
+#include "Profiler.h"
+#include <chrono>
+#include <cstdio>
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+AssetLoader::~AssetLoader() {
+    // Jobs not started yet are dropped, running ones finish first
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+int AssetLoader::add(const char* name, LoadGroup group, Stage load, Stage upload, std::vector<int> after) {
+    Job job;
+    job.name = name;
+    job.group = group;
+    job.load = std::move(load);
+    job.upload = std::move(upload);
+    job.after = std::move(after);
+    stageCount += job.upload ? 2 : 1;
+    remaining[group]++;
+    jobs.push_back(std::move(job));
+    return static_cast<int>(jobs.size() - 1);
+}
+
+void AssetLoader::start(unsigned int threadCount) {
+    for (unsigned int i = 0; i < threadCount; i++) {
+        threads.emplace_back(&AssetLoader::loaderLoop, this);
+    }
+}
+
+void AssetLoader::promote(LoadGroup group) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 0; i < jobs.size(); i++) {
+        if (jobs[i].group == group && jobs[i].state != JOB_DONE) promoteJob(static_cast<int>(i));
+    }
+}
+
+void AssetLoader::promoteJob(int index) {
+    Job& job = jobs[index];
+    if (job.priority > 0) return;
+    job.priority = 1;
+    for (int dependency : job.after) {
+        promoteJob(dependency);
+    }
+}
+
+void AssetLoader::upload(double budgetSeconds) {
+    auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex);
+    do {
+        int index = nextUpload();
+        if (index < 0) return;
+
+        Job& job = jobs[index];
+        job.state = JOB_UPLOADING;
+        lock.unlock();
+        auto stageStart = std::chrono::steady_clock::now();
+        job.upload();
+        job.uploadSeconds = secondsSince(stageStart);
+        lock.lock();
+
+        stagesDone++;
+        finish(job);
+    } while (secondsSince(start) < budgetSeconds);
+}
+
+bool AssetLoader::done(LoadGroup group) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return remaining[group] == 0;
+}
+
+bool AssetLoader::done() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int count : remaining) {
+        if (count > 0) return false;
+    }
+    return true;
+}
+
+float AssetLoader::progress() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stageCount > 0 ? static_cast<float>(stagesDone) / stageCount : 1.0f;
+}
+
+const char* AssetLoader::currentName() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return current;
+}
+
+void AssetLoader::printTimes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::printf("Asset loading, CPU and GL time per job:\n");
+    for (const Job& job : jobs) {
+        if (job.state != JOB_DONE) {
+            std::printf("  %-32s   still loading\n", job.name);
+        } else {
+            std::printf("  %-32s %8.1f ms %8.1f ms\n", job.name, job.loadSeconds * 1000.0, job.uploadSeconds * 1000.0);
+        }
+    }
+    std::fflush(stdout);
+}
+
+void AssetLoader::loaderLoop() {
+    PROFILE_THREAD("loader");
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        int index = -1;
+        changed.wait(lock, [this, &index]() {
+            if (stopping) return true;
+            index = nextLoad();
+            if (index >= 0) return true;
+            // Nothing left to start at all
+            for (const Job& job : jobs) {
+                if (job.state == JOB_WAITING) return false;
+            }
+            return true;
+        });
+        if (stopping || index < 0) return;
+
+        Job& job = jobs[index];
+        job.state = JOB_LOADING;
+        current = job.name;
+        lock.unlock();
+        auto stageStart = std::chrono::steady_clock::now();
+        job.load();
+        job.loadSeconds = secondsSince(stageStart);
+        lock.lock();
+
+        stagesDone++;
+        if (job.upload) {
+            job.state = JOB_LOADED;
+        } else {
+            finish(job);
+        }
+        // Jobs waiting on this one may be ready now
+        changed.notify_all();
+    }
+}
+
+int AssetLoader::nextLoad() const {
+    int best = -1;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        const Job& job = jobs[i];
+        if (job.state != JOB_WAITING) continue;
+        if (best >= 0 && job.priority <= jobs[best].priority) continue;
+
+        bool ready = true;
+        for (int dependency : job.after) {
+            if (jobs[dependency].state == JOB_WAITING || jobs[dependency].state == JOB_LOADING) ready = false;
+        }
+        if (ready) best = static_cast<int>(i);
+    }
+    return best;
+}
+
+int AssetLoader::nextUpload() const {
+    int best = -1;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        if (jobs[i].state != JOB_LOADED) continue;
+        if (best < 0 || jobs[i].priority > jobs[best].priority) best = static_cast<int>(i);
+    }
+    return best;
+}
+
+void AssetLoader::finish(Job& job) {
+    job.state = JOB_DONE;
+    remaining[job.group]--;
+}
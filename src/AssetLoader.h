@@ -0,0 +1,84 @@
+// AssetLoader.h
+// Loads assets in the background as a small graph of jobs. Every job has a CPU stage
+// (reading files, decoding images, importing models) that runs on loader threads, and an
+// optional GL stage that the GL thread runs from upload() within a time budget, so the
+// menu keeps drawing while the game loads. Jobs start in priority order once the jobs
+// they depend on have finished their CPU stage.
+
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+enum LoadGroup {
+    LOAD_GROUP_GAMEPLAY,  // Needed before a game can start
+    LOAD_GROUP_EFFECTS,   // Can stream in while the game is running
+    LOAD_GROUP_COUNT
+};
+
+class AssetLoader {
+public:
+    using Stage = std::function<void()>;
+
+    AssetLoader() = default;
+    ~AssetLoader();
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // Add a job before start(). Its CPU stage waits for the CPU stage of every job in 'after'.
+    // Returns the job's index for use in later 'after' lists.
+    int add(const char* name, LoadGroup group, Stage load, Stage upload = nullptr, std::vector<int> after = {});
+    void start(unsigned int threadCount);
+
+    // Move the unfinished jobs of a group, and what they wait for, ahead of every other job
+    void promote(LoadGroup group);
+
+    // Run finished CPU stages' GL stages on this thread until the budget is spent.
+    // At least one stage runs per call, so the loader always makes progress.
+    void upload(double budgetSeconds);
+
+    bool done(LoadGroup group) const;
+    bool done() const;
+    // Fraction of all stages finished, for a progress bar
+    float progress() const;
+    // Name of the job started last
+    const char* currentName() const;
+    // Time each job spent in its two stages
+    void printTimes() const;
+
+private:
+    enum JobState { JOB_WAITING, JOB_LOADING, JOB_LOADED, JOB_UPLOADING, JOB_DONE };
+    struct Job {
+        const char* name;
+        LoadGroup group;
+        Stage load;
+        Stage upload;
+        std::vector<int> after;
+        int priority = 0;
+        JobState state = JOB_WAITING;
+        double loadSeconds = 0.0;
+        double uploadSeconds = 0.0;
+    };
+
+    std::vector<Job> jobs;
+    std::vector<std::thread> threads;
+    mutable std::mutex mutex;
+    std::condition_variable changed;
+    bool stopping = false;
+    int stagesDone = 0;
+    int stageCount = 0;
+    int remaining[LOAD_GROUP_COUNT] = {};
+    const char* current = "";
+
+    void loaderLoop();
+    int nextLoad() const;    // Highest priority job ready for its CPU stage, or -1
+    int nextUpload() const;  // Highest priority job ready for its GL stage, or -1
+    void promoteJob(int index);
+    void finish(Job& job);
+};
+
+#endif // ASSET_LOADER_H
@@ -0,0 +1,152 @@
+#include "BoxBatch.h"
+
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define BOX_BATCH_SSE 1
+#endif
+
+void BoxBatch::add(const Hitbox& box) {
+    minX.push_back(box.minCorner.x);
+    minY.push_back(box.minCorner.y);
+    minZ.push_back(box.minCorner.z);
+    maxX.push_back(box.maxCorner.x);
+    maxY.push_back(box.maxCorner.y);
+    maxZ.push_back(box.maxCorner.z);
+}
+
+void BoxBatch::clear() {
+    minX.clear(); minY.clear(); minZ.clear();
+    maxX.clear(); maxY.clear(); maxZ.clear();
+}
+
+void BoxBatch::reserve(size_t count) {
+    minX.reserve(count); minY.reserve(count); minZ.reserve(count);
+    maxX.reserve(count); maxY.reserve(count); maxZ.reserve(count);
+}
+
+BoxColumns BoxBatch::columns() const {
+    return BoxColumns{minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data()};
+}
+
+// Index of the lowest set bit, 'bits' must not be zero
+static inline int lowestBit(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(bits);
+#else
+    int index = 0;
+    while (!(bits & 1)) {
+        bits >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+static inline bool overlapsOne(const Hitbox& query, const BoxColumns& boxes, size_t i) {
+    return boxes.maxX[i] >= query.minCorner.x && boxes.minX[i] <= query.maxCorner.x
+        && boxes.maxY[i] >= query.minCorner.y && boxes.minY[i] <= query.maxCorner.y
+        && boxes.maxZ[i] >= query.minCorner.z && boxes.minZ[i] <= query.maxCorner.z;
+}
+
+void overlapBatchMask(const Hitbox& query, const BoxColumns& boxes, size_t count, uint64_t* mask) {
+    for (size_t word = 0; word < (count + 63) / 64; word++) mask[word] = 0;
+
+    size_t i = 0;
+
+#if defined(__AVX512F__)
+    // 16 boxes per compare, the result is already a bit mask
+    {
+        __m512 qMinX = _mm512_set1_ps(query.minCorner.x), qMaxX = _mm512_set1_ps(query.maxCorner.x);
+        __m512 qMinY = _mm512_set1_ps(query.minCorner.y), qMaxY = _mm512_set1_ps(query.maxCorner.y);
+        __m512 qMinZ = _mm512_set1_ps(query.minCorner.z), qMaxZ = _mm512_set1_ps(query.maxCorner.z);
+        for (; i + 16 <= count; i += 16) {
+            __mmask16 hit = _mm512_cmp_ps_mask(_mm512_loadu_ps(boxes.maxX + i), qMinX, _CMP_GE_OQ);
+            hit = _mm512_mask_cmp_ps_mask(hit, _mm512_loadu_ps(boxes.minX + i), qMaxX, _CMP_LE_OQ);
+            hit = _mm512_mask_cmp_ps_mask(hit, _mm512_loadu_ps(boxes.maxY + i), qMinY, _CMP_GE_OQ);
+            hit = _mm512_mask_cmp_ps_mask(hit, _mm512_loadu_ps(boxes.minY + i), qMaxY, _CMP_LE_OQ);
+            hit = _mm512_mask_cmp_ps_mask(hit, _mm512_loadu_ps(boxes.maxZ + i), qMinZ, _CMP_GE_OQ);
+            hit = _mm512_mask_cmp_ps_mask(hit, _mm512_loadu_ps(boxes.minZ + i), qMaxZ, _CMP_LE_OQ);
+            mask[i / 64] |= static_cast<uint64_t>(hit) << (i % 64);
+        }
+    }
+#endif
+
+#if defined(__AVX2__)
+    // 8 boxes per compare
+    {
+        __m256 qMinX = _mm256_set1_ps(query.minCorner.x), qMaxX = _mm256_set1_ps(query.maxCorner.x);
+        __m256 qMinY = _mm256_set1_ps(query.minCorner.y), qMaxY = _mm256_set1_ps(query.maxCorner.y);
+        __m256 qMinZ = _mm256_set1_ps(query.minCorner.z), qMaxZ = _mm256_set1_ps(query.maxCorner.z);
+        for (; i + 8 <= count; i += 8) {
+            __m256 hit = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(boxes.maxX + i), qMinX, _CMP_GE_OQ),
+                                       _mm256_cmp_ps(_mm256_loadu_ps(boxes.minX + i), qMaxX, _CMP_LE_OQ));
+            hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_loadu_ps(boxes.maxY + i), qMinY, _CMP_GE_OQ));
+            hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_loadu_ps(boxes.minY + i), qMaxY, _CMP_LE_OQ));
+            hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_loadu_ps(boxes.maxZ + i), qMinZ, _CMP_GE_OQ));
+            hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_loadu_ps(boxes.minZ + i), qMaxZ, _CMP_LE_OQ));
+            mask[i / 64] |= static_cast<uint64_t>(_mm256_movemask_ps(hit)) << (i % 64);
+        }
+    }
+#endif
+
+#if defined(BOX_BATCH_SSE)
+    // 4 boxes per compare
+    {
+        __m128 qMinX = _mm_set1_ps(query.minCorner.x), qMaxX = _mm_set1_ps(query.maxCorner.x);
+        __m128 qMinY = _mm_set1_ps(query.minCorner.y), qMaxY = _mm_set1_ps(query.maxCorner.y);
+        __m128 qMinZ = _mm_set1_ps(query.minCorner.z), qMaxZ = _mm_set1_ps(query.maxCorner.z);
+        for (; i + 4 <= count; i += 4) {
+            __m128 hit = _mm_and_ps(_mm_cmpge_ps(_mm_loadu_ps(boxes.maxX + i), qMinX),
+                                    _mm_cmple_ps(_mm_loadu_ps(boxes.minX + i), qMaxX));
+            hit = _mm_and_ps(hit, _mm_cmpge_ps(_mm_loadu_ps(boxes.maxY + i), qMinY));
+            hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_loadu_ps(boxes.minY + i), qMaxY));
+            hit = _mm_and_ps(hit, _mm_cmpge_ps(_mm_loadu_ps(boxes.maxZ + i), qMinZ));
+            hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_loadu_ps(boxes.minZ + i), qMaxZ));
+            mask[i / 64] |= static_cast<uint64_t>(_mm_movemask_ps(hit)) << (i % 64);
+        }
+    }
+#endif
+
+    // Whatever is left over, or everything on CPUs without a vector path
+    for (; i < count; i++) {
+        if (overlapsOne(query, boxes, i)) mask[i / 64] |= uint64_t(1) << (i % 64);
+    }
+}
+
+size_t overlapBatch(const Hitbox& query, const BoxColumns& boxes, size_t count, uint32_t* results) {
+    size_t found = 0;
+
+    // Work through the boxes 64 at a time so the mask lives on the stack
+    for (size_t first = 0; first < count; first += 64) {
+        size_t chunk = count - first < 64 ? count - first : 64;
+        uint64_t bits;
+        overlapBatchMask(query, boxes.offset(first), chunk, &bits);
+
+        // Turn the set bits into a compact index list
+        while (bits) {
+            results[found++] = static_cast<uint32_t>(first + lowestBit(bits));
+            bits &= bits - 1;
+        }
+    }
+    return found;
+}
+
+size_t overlapBatchScalar(const Hitbox& query, const BoxColumns& boxes, size_t count, uint32_t* results) {
+    size_t found = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (overlapsOne(query, boxes, i)) results[found++] = static_cast<uint32_t>(i);
+    }
+    return found;
+}
+
+const char* overlapBatchPath() {
+#if defined(__AVX512F__)
+    return "AVX-512";
+#elif defined(__AVX2__)
+    return "AVX2";
+#elif defined(BOX_BATCH_SSE)
+    return "SSE";
+#else
+    return "scalar";
+#endif
+}
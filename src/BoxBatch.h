@@ -0,0 +1,54 @@
+// BoxBatch.h
+// Tests one query box against many boxes stored as separate min/max arrays (SoA).
+// The widest instruction set the compiler targets is used: 16 boxes per compare with
+// AVX-512, 8 with AVX2, 4 with SSE, and a plain loop on other CPUs or for the tail.
+
+#ifndef BOX_BATCH_H
+#define BOX_BATCH_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "hitbox.hpp"
+
+// Pointers to the six bound arrays of a set of boxes
+struct BoxColumns {
+    const float* minX;
+    const float* minY;
+    const float* minZ;
+    const float* maxX;
+    const float* maxY;
+    const float* maxZ;
+
+    // Columns starting at box 'first'
+    BoxColumns offset(size_t first) const {
+        return BoxColumns{minX + first, minY + first, minZ + first, maxX + first, maxY + first, maxZ + first};
+    }
+};
+
+// Owning SoA storage for boxes that are tested in batches
+class BoxBatch {
+public:
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+
+    void add(const Hitbox& box);
+    void clear();
+    void reserve(size_t count);
+    size_t size() const { return minX.size(); }
+
+    BoxColumns columns() const;
+};
+
+// Set bit i of mask[i / 64] when box i overlaps the query (same rule as Hitbox::isColliding).
+// 'mask' needs (count + 63) / 64 words.
+void overlapBatchMask(const Hitbox& query, const BoxColumns& boxes, size_t count, uint64_t* mask);
+// Write the indices of the boxes overlapping the query to 'results' (room for 'count'), returns how many
+size_t overlapBatch(const Hitbox& query, const BoxColumns& boxes, size_t count, uint32_t* results);
+// Plain loop version of overlapBatch, kept as a reference for testing and benchmarks
+size_t overlapBatchScalar(const Hitbox& query, const BoxColumns& boxes, size_t count, uint32_t* results);
+
+// Name of the instruction set the batch kernel was compiled for
+const char* overlapBatchPath();
+
+#endif // BOX_BATCH_H
@@ -0,0 +1,237 @@
+#include "CollisionWorld.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// Boxes per leaf, small enough that a leaf is tested in a few compares
+static const uint32_t MAX_LEAF_SIZE = 4;
+// Deepest tree the traversal stack can hold
+static const int MAX_DEPTH = 64;
+
+void CollisionWorld::addBox(const Hitbox& box, uint32_t layer) {
+    boxes.push_back(box);
+    layers.push_back(layer);
+}
+
+void CollisionWorld::clear() {
+    boxes.clear();
+    layers.clear();
+    boxColumns.clear();
+    nodes.clear();
+}
+
+void CollisionWorld::build() {
+    nodes.clear();
+    if (boxes.empty()) return;
+
+    nodes.reserve(2 * boxes.size());
+    buildNode(0, static_cast<uint32_t>(boxes.size()));
+
+    // Mirror the final box order into separate arrays for the batch overlap test
+    boxColumns.clear();
+    boxColumns.reserve(boxes.size());
+    for (const Hitbox& box : boxes) boxColumns.add(box);
+}
+
+uint32_t CollisionWorld::buildNode(uint32_t first, uint32_t count) {
+    uint32_t nodeIndex = static_cast<uint32_t>(nodes.size());
+    nodes.push_back(Node());
+
+    // Bounds of every box in the node, and of their centres to pick a split axis
+    glm::vec3 boundsMin(FLT_MAX), boundsMax(-FLT_MAX);
+    glm::vec3 centreMin(FLT_MAX), centreMax(-FLT_MAX);
+    for (uint32_t i = first; i < first + count; i++) {
+        boundsMin = glm::min(boundsMin, boxes[i].minCorner);
+        boundsMax = glm::max(boundsMax, boxes[i].maxCorner);
+        glm::vec3 centre = (boxes[i].minCorner + boxes[i].maxCorner) * 0.5f;
+        centreMin = glm::min(centreMin, centre);
+        centreMax = glm::max(centreMax, centre);
+    }
+    nodes[nodeIndex].boundsMin = boundsMin;
+    nodes[nodeIndex].boundsMax = boundsMax;
+
+    if (count <= MAX_LEAF_SIZE) {
+        nodes[nodeIndex].rightOrFirst = first;
+        nodes[nodeIndex].count = count;
+        return nodeIndex;
+    }
+
+    // Split at the median centre along the longest axis
+    glm::vec3 extent = centreMax - centreMin;
+    int axis = 0;
+    if (extent.y > extent[axis]) axis = 1;
+    if (extent.z > extent[axis]) axis = 2;
+
+    uint32_t half = count / 2;
+    std::vector<uint32_t> order(count);
+    for (uint32_t i = 0; i < count; i++) order[i] = first + i;
+    std::nth_element(order.begin(), order.begin() + half, order.end(), [&](uint32_t a, uint32_t b) {
+        return boxes[a].minCorner[axis] + boxes[a].maxCorner[axis] < boxes[b].minCorner[axis] + boxes[b].maxCorner[axis];
+    });
+
+    // Apply the new order to the boxes and their layers
+    std::vector<Hitbox> sortedBoxes(count);
+    std::vector<uint32_t> sortedLayers(count);
+    for (uint32_t i = 0; i < count; i++) {
+        sortedBoxes[i] = boxes[order[i]];
+        sortedLayers[i] = layers[order[i]];
+    }
+    std::copy(sortedBoxes.begin(), sortedBoxes.end(), boxes.begin() + first);
+    std::copy(sortedLayers.begin(), sortedLayers.end(), layers.begin() + first);
+
+    // Left child directly follows its parent, the right child comes after the left subtree
+    buildNode(first, half);
+    uint32_t right = buildNode(first + half, count - half);
+    nodes[nodeIndex].rightOrFirst = right;
+    nodes[nodeIndex].count = 0;
+    return nodeIndex;
+}
+
+template <typename NodeTest, typename VisitLeaf>
+void CollisionWorld::traverseLeaves(NodeTest&& nodeTest, VisitLeaf&& visitLeaf) const {
+    if (nodes.empty()) return;
+
+    uint32_t stack[MAX_DEPTH];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        uint32_t nodeIndex = stack[--stackSize];
+        const Node& node = nodes[nodeIndex];
+        if (!nodeTest(node.boundsMin, node.boundsMax)) continue;
+
+        if (node.count > 0) {
+            if (visitLeaf(node.rightOrFirst, node.count)) return;
+        } else {
+            stack[stackSize++] = node.rightOrFirst;
+            stack[stackSize++] = nodeIndex + 1;
+        }
+    }
+}
+
+template <typename NodeTest, typename Visit>
+void CollisionWorld::traverse(NodeTest&& nodeTest, uint32_t layerMask, Visit&& visit) const {
+    traverseLeaves(nodeTest, [&](uint32_t first, uint32_t count) {
+        for (uint32_t i = first; i < first + count; i++) {
+            if ((layers[i] & layerMask) && visit(i)) return true;
+        }
+        return false;
+    });
+}
+
+template <typename Visit>
+void CollisionWorld::traverseOverlaps(const Hitbox& box, uint32_t layerMask, Visit&& visit) const {
+    BoxColumns columns = boxColumns.columns();
+    traverseLeaves([&](const glm::vec3& mn, const glm::vec3& mx) { return box.isColliding(Hitbox(mn, mx)); },
+                   [&](uint32_t first, uint32_t count) {
+                       // Leaves hold at most MAX_LEAF_SIZE boxes, so one mask word covers them
+                       uint64_t bits;
+                       overlapBatchMask(box, columns.offset(first), count, &bits);
+                       for (uint32_t bit = 0; bit < count; bit++) {
+                           uint32_t i = first + bit;
+                           if (((bits >> bit) & 1) && (layers[i] & layerMask) && visit(i)) return true;
+                       }
+                       return false;
+                   });
+}
+
+bool CollisionWorld::overlapsAny(const Hitbox& box, uint32_t layerMask) const {
+    return firstOverlap(box, layerMask) != UINT32_MAX;
+}
+
+uint32_t CollisionWorld::firstOverlap(const Hitbox& box, uint32_t layerMask) const {
+    uint32_t found = UINT32_MAX;
+    traverseOverlaps(box, layerMask, [&](uint32_t i) {
+        found = i;
+        return true;
+    });
+    return found;
+}
+
+void CollisionWorld::queryOverlaps(const Hitbox& box, uint32_t layerMask, std::vector<uint32_t>& results) const {
+    results.clear();
+    traverseOverlaps(box, layerMask, [&](uint32_t i) {
+        results.push_back(i);
+        return false;
+    });
+}
+
+// Slab test of a segment against a box. Returns false when the segment misses, otherwise
+// tNear is where the segment enters the box (negative when it starts inside or touching)
+// and nearAxis the axis of the face it enters through.
+static bool segmentSlabs(const glm::vec3& from, const glm::vec3& delta, const glm::vec3& boxMin, const glm::vec3& boxMax,
+                         float& tNear, int& nearAxis) {
+    tNear = -FLT_MAX;
+    nearAxis = -1;
+    float tFar = FLT_MAX;
+
+    for (int axis = 0; axis < 3; axis++) {
+        if (std::fabs(delta[axis]) < 1e-8f) {
+            // Parallel to the slab, miss unless the start lies inside it
+            if (from[axis] < boxMin[axis] || from[axis] > boxMax[axis]) return false;
+            continue;
+        }
+        float inverse = 1.0f / delta[axis];
+        float t1 = (boxMin[axis] - from[axis]) * inverse;
+        float t2 = (boxMax[axis] - from[axis]) * inverse;
+        if (t1 > t2) std::swap(t1, t2);
+        if (t1 > tNear) {
+            tNear = t1;
+            nearAxis = axis;
+        }
+        tFar = std::min(tFar, t2);
+        if (tNear > tFar || tFar < 0.0f) return false;
+    }
+    return tNear <= 1.0f;
+}
+
+// A hit only counts when the segment enters the box through a face it moves towards.
+// Segments that start inside or touching a box are let go, so a cow resting against a
+// wall can still be knocked away from it.
+static bool segmentEntersBox(const glm::vec3& from, const glm::vec3& delta, const glm::vec3& boxMin,
+                             const glm::vec3& boxMax, float& entryTime, glm::vec3& normal) {
+    float tNear;
+    int nearAxis;
+    if (!segmentSlabs(from, delta, boxMin, boxMax, tNear, nearAxis) || nearAxis < 0 || tNear < 0.0f) return false;
+
+    normal = glm::vec3(0.0f);
+    normal[nearAxis] = delta[nearAxis] > 0.0f ? -1.0f : 1.0f;
+    if (glm::dot(normal, delta) >= 0.0f) return false;
+    entryTime = tNear;
+    return true;
+}
+
+bool CollisionWorld::segmentCast(const glm::vec3& from, const glm::vec3& to, uint32_t layerMask, SegmentHit& hit,
+                                 const glm::vec3& extent) const {
+    glm::vec3 delta = to - from;
+    hit = SegmentHit();
+
+    traverse([&](const glm::vec3& mn, const glm::vec3& mx) {
+                 // Nodes are entered even when the segment starts inside them, their boxes may not contain it
+                 float tNear;
+                 int nearAxis;
+                 return segmentSlabs(from, delta, mn - extent, mx + extent, tNear, nearAxis)
+                     && std::max(tNear, 0.0f) <= hit.time;
+             },
+             layerMask,
+             [&](uint32_t i) {
+                 float time;
+                 glm::vec3 normal;
+                 if (segmentEntersBox(from, delta, boxes[i].minCorner - extent, boxes[i].maxCorner + extent, time, normal)
+                     && (time < hit.time || hit.box == UINT32_MAX)) {
+                     hit.time = time;
+                     hit.normal = normal;
+                     hit.box = i;
+                 }
+                 return false;
+             });
+
+    return hit.box != UINT32_MAX;
+}
+
+bool CollisionWorld::sweepBox(const Hitbox& box, const glm::vec3& displacement, uint32_t layerMask, SegmentHit& hit) const {
+    // Shrink the moving box to its centre and grow the static boxes by its half size instead
+    glm::vec3 center = (box.minCorner + box.maxCorner) * 0.5f;
+    glm::vec3 halfSize = (box.maxCorner - box.minCorner) * 0.5f;
+    return segmentCast(center, center + displacement, layerMask, hit, halfSize);
+}
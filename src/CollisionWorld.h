@@ -0,0 +1,89 @@
+// CollisionWorld.h
+// Static collision geometry (rocks, walls) collected once after the level is placed and
+// stored as a flattened bounding volume hierarchy. Moving objects query it every tick.
+
+#ifndef COLLISION_WORLD_H
+#define COLLISION_WORLD_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "hitbox.hpp"
+#include "BoxBatch.h"
+
+// Layers a static box can belong to, queries pass a mask of the layers they care about
+enum CollisionLayer : uint32_t {
+    COLLISION_ROCK = 1 << 0,
+    COLLISION_TREE = 1 << 1,
+    COLLISION_WALL = 1 << 2,
+
+    COLLISION_ENVIRONMENT = COLLISION_ROCK | COLLISION_TREE,
+    COLLISION_ALL = 0xFFFFFFFFu,
+};
+
+// Result of a segment test
+struct SegmentHit {
+    float time = 1.0f;           // Fraction along the segment where the first contact happens
+    glm::vec3 normal{0.0f};      // Face normal of the box that was hit
+    uint32_t box = UINT32_MAX;   // Index of the box that was hit
+};
+
+class CollisionWorld {
+public:
+    // Add a box before build(). Boxes are reordered by build(), so look them up
+    // through the indices returned by queries.
+    void addBox(const Hitbox& box, uint32_t layer);
+    // Build the hierarchy over every box added so far
+    void build();
+    void clear();
+
+    // True if the box overlaps any static box on the given layers
+    bool overlapsAny(const Hitbox& box, uint32_t layerMask) const;
+    // Find the first static box overlapping the box, returns its index or UINT32_MAX
+    uint32_t firstOverlap(const Hitbox& box, uint32_t layerMask) const;
+    // Collect the indices of every static box overlapping the box
+    void queryOverlaps(const Hitbox& box, uint32_t layerMask, std::vector<uint32_t>& results) const;
+
+    // Test the segment from -> to against the static boxes grown by 'extent' on every side,
+    // which is the same as sweeping a box with those half extents along the segment. Only
+    // boxes the segment moves into count, a segment starting inside or touching a box can
+    // leave it freely.
+    bool segmentCast(const glm::vec3& from, const glm::vec3& to, uint32_t layerMask, SegmentHit& hit,
+                     const glm::vec3& extent = glm::vec3(0.0f)) const;
+    // Sweep a box by 'displacement' and find the first static box it touches (swept AABB).
+    // hit.time is the fraction of the displacement that can be moved before contact.
+    bool sweepBox(const Hitbox& box, const glm::vec3& displacement, uint32_t layerMask, SegmentHit& hit) const;
+
+    const Hitbox& getBox(uint32_t index) const { return boxes[index]; }
+    uint32_t getLayer(uint32_t index) const { return layers[index]; }
+    size_t size() const { return boxes.size(); }
+
+private:
+    // Node of the flattened tree. Interior nodes keep their left child right after them
+    // and store the index of the right child; leaves store a range of boxes.
+    struct Node {
+        glm::vec3 boundsMin;
+        uint32_t rightOrFirst;   // Right child for interior nodes, first box for leaves
+        glm::vec3 boundsMax;
+        uint32_t count;          // Number of boxes in a leaf, 0 for interior nodes
+    };
+
+    std::vector<Hitbox> boxes;       // Reordered to match the leaves after build()
+    std::vector<uint32_t> layers;
+    BoxBatch boxColumns;             // Same boxes as separate arrays for the batch overlap test
+    std::vector<Node> nodes;
+
+    uint32_t buildNode(uint32_t first, uint32_t count);
+
+    // Call visitLeaf(first, count) for every leaf whose node passes nodeTest, stops early when it returns true
+    template <typename NodeTest, typename VisitLeaf>
+    void traverseLeaves(NodeTest&& nodeTest, VisitLeaf&& visitLeaf) const;
+    // Walk the boxes of every leaf whose node passes nodeTest, stops early when visit returns true
+    template <typename NodeTest, typename Visit>
+    void traverse(NodeTest&& nodeTest, uint32_t layerMask, Visit&& visit) const;
+    // Visit the boxes on the given layers overlapping 'box', testing a whole leaf at once
+    template <typename Visit>
+    void traverseOverlaps(const Hitbox& box, uint32_t layerMask, Visit&& visit) const;
+};
+
+#endif // COLLISION_WORLD_H
@@ -0,0 +1,270 @@
+#include "CowSystem.h"
+#include "AgentDraw.h"
+#include "ParallelFor.h"
+#include "Random.h"
+#include "Log.h"
+#include "Profiler.h"
+#include <cmath>
+
+// Movement tuning shared by every cow
+static const float COW_MAX_SPEED = 20.0f;          // Maximum speed a cow can reach
+static const float COW_ACCELERATION = 1.5f;        // Rate at which a cow accelerates
+static const float COW_DECELERATION = 3.0f;        // Rate at which a cow decelerates
+static const float COW_ROTATION_SPEED = 50.0f;     // Degrees per second
+static const float COW_MAX_DISTANCE = 10.0f;       // Distance walked before stopping
+static const float COW_KNOCKBACK_DECELERATION = 5.0f;
+static const float COW_KNOCKBACK_MULTIPLIER = 5.0f;
+static const float COW_CONTACT_SKIN = 0.01f;        // Gap left between a knocked back cow and what it hits
+static const glm::vec3 COW_BOX_MIN(-1.0f, 0.0f, -1.0f);
+static const glm::vec3 COW_BOX_MAX(1.0f, 2.0f, 1.0f);
+static const float COW_MODEL_SCALE = 0.1f;  // Size the model is drawn at
+
+// Cows per worker chunk, smaller herds are updated on the calling thread
+static const size_t COW_CHUNK = 256;
+
+CowSystem::CowSystem(size_t capacity, uint64_t seed) : seed(seed), randomKey(counterKey(seed, 0)) {
+    agents.reserve(capacity);
+    activity.reserve(capacity);
+}
+
+AgentHandle CowSystem::spawn(const glm::vec3& position) {
+    AgentHandle handle = agents.spawn(position);
+    size_t index = agents.indexOf(handle);
+    agents.resetAgent(index, position, COW_BOX_MIN, COW_BOX_MAX);
+    activity.add(static_cast<uint32_t>(index));
+    return handle;
+}
+
+size_t CowSystem::spawnMany(const std::vector<glm::vec3>& positions) {
+    activity.reserve(agents.size() + positions.size());
+    size_t first = agents.spawnMany(positions);
+    for (size_t i = 0; i < positions.size(); i++) {
+        agents.resetAgent(first + i, positions[i], COW_BOX_MIN, COW_BOX_MAX);
+        activity.add(static_cast<uint32_t>(first + i));
+    }
+    return first;
+}
+
+void CowSystem::reset(const std::vector<glm::vec3>& positions) {
+    // New round, so the agents do not replay the random choices of the last game
+    resetCount++;
+    randomKey = counterKey(seed, resetCount);
+    for (size_t i = 0; i < agents.size() && i < positions.size(); ++i) {
+        agents.resetAgent(i, positions[i], COW_BOX_MIN, COW_BOX_MAX);
+    }
+    activity.reset(agents.size());
+    capture();
+    publish();
+}
+
+void CowSystem::update(float deltaTime, const CollisionWorld& world) {
+    tick++;
+    tickDelta = deltaTime;
+    randomValues.resize(agents.size());
+
+    // Wake the cows whose stop timer runs out and drop the ones that fell asleep
+    activity.beginTick(agents, tick, deltaTime);
+    const std::vector<uint32_t>& awake = activity.awake();
+
+    parallelFor(awake.size(), COW_CHUNK, [&](size_t begin, size_t end) {
+        PROFILE_ZONE("cow chunk");
+
+        // One random number per cow for this tick, keyed by the cow's id and the tick. The
+        // ids of the awake cows are gathered into blocks so each block is filled by one call.
+        for (size_t blockBegin = begin; blockBegin < end; blockBegin += COW_CHUNK) {
+            size_t blockSize = std::min(COW_CHUNK, end - blockBegin);
+            uint32_t blockIds[COW_CHUNK];
+            float blockRandom[COW_CHUNK];
+            for (size_t k = 0; k < blockSize; k++) blockIds[k] = agents.ids()[awake[blockBegin + k]];
+            fillEntityRandom(randomKey, tick, blockIds, blockSize, blockRandom);
+            for (size_t k = 0; k < blockSize; k++) randomValues[awake[blockBegin + k]] = blockRandom[k];
+        }
+
+        for (size_t k = begin; k < end; k++) {
+            uint32_t i = awake[k];
+
+            // If cow is knocked back, skip normal movement
+            if (agents.velX[i] != 0.0f || agents.velZ[i] != 0.0f) {
+                applyKnockback(i, deltaTime, world);
+            } else {
+                moveRandomly(i, deltaTime, world);
+            }
+
+            // Update the cow's hitbox position
+            agents.refreshBounds(i, i + 1, COW_BOX_MIN, COW_BOX_MAX);
+        }
+    });
+}
+
+void CowSystem::applyKnockback(size_t i, float deltaTime, const CollisionWorld& world) {
+    float speed = std::sqrt(agents.velX[i] * agents.velX[i] + agents.velZ[i] * agents.velZ[i]);
+    glm::vec3 direction(agents.velX[i] / speed, 0.0f, agents.velZ[i] / speed);
+
+    // The knockback slows down at a constant rate, so the distance covered this tick is exact
+    float moveTime = std::min(deltaTime, speed / COW_KNOCKBACK_DECELERATION);
+    float distance = speed * moveTime - 0.5f * COW_KNOCKBACK_DECELERATION * moveTime * moveTime;
+    float newSpeed = speed - COW_KNOCKBACK_DECELERATION * moveTime;
+
+    // Sweep the hitbox along the whole move so fast cows cannot pass through rocks or walls
+    glm::vec3 position = agents.getPosition(i);
+    Hitbox hitbox(position + COW_BOX_MIN, position + COW_BOX_MAX);
+    SegmentHit hit;
+    if (distance > 0.0f && world.sweepBox(hitbox, direction * distance, COLLISION_ALL, hit)) {
+        // Stop just short of the contact point
+        float travel = std::max(0.0f, hit.time * distance - COW_CONTACT_SKIN);
+        agents.posX[i] += direction.x * travel;
+        agents.posZ[i] += direction.z * travel;
+
+        agents.velX[i] = 0.0f; // Stop the cow
+        agents.velZ[i] = 0.0f;
+        return;
+    }
+
+    agents.posX[i] += direction.x * distance;
+    agents.posZ[i] += direction.z * distance;
+
+    // Stop when velocity is near zero
+    if (newSpeed * newSpeed < 0.01f) {
+        agents.velX[i] = 0.0f;
+        agents.velZ[i] = 0.0f;
+    } else {
+        agents.velX[i] = direction.x * newSpeed;
+        agents.velZ[i] = direction.z * newSpeed;
+    }
+}
+
+void CowSystem::moveRandomly(size_t i, float deltaTime, const CollisionWorld& world) {
+    uint8_t& flags = agents.flags[i];
+
+    if (flags & AGENT_ROTATING) {
+        flags |= AGENT_MOVING;
+
+        // Smoothly rotate towards the target angle
+        float rotationStep = COW_ROTATION_SPEED * deltaTime;
+        float& target = agents.targetRotation[i];
+
+        if (std::fabs(target) > rotationStep) {
+            // Continue rotating towards the target
+            agents.totalRotation[i] += (target > 0 ? rotationStep : -rotationStep);
+            target -= (target > 0 ? rotationStep : -rotationStep);
+        } else {
+            // Finish the rotation and update the direction vector
+            agents.totalRotation[i] += target;
+            target = 0.0f;
+            flags &= ~AGENT_ROTATING;
+
+            // Forward direction is +Z rotated around the Y axis
+            float radians = glm::radians(agents.totalRotation[i]);
+            agents.dirX[i] = std::sin(radians);
+            agents.dirZ[i] = std::cos(radians);
+        }
+    }
+
+    if (flags & AGENT_MOVING) {
+        float& speed = agents.speed[i];
+
+        // Accelerate the cow towards max speed
+        if (speed < COW_MAX_SPEED) {
+            speed = std::min(COW_MAX_SPEED, speed + COW_ACCELERATION * deltaTime);
+        }
+
+        // Move forward in the current direction based on the current speed
+        glm::vec3 position = agents.getPosition(i);
+        glm::vec3 direction(agents.dirX[i], 0.0f, agents.dirZ[i]);
+        glm::vec3 newPosition = position + direction * speed * deltaTime;
+        agents.distanceTraveled[i] += speed * deltaTime;
+
+        // Check if the cow has traveled the maximum distance
+        if (agents.distanceTraveled[i] >= COW_MAX_DISTANCE) {
+            flags &= ~AGENT_MOVING;
+            agents.distanceTraveled[i] = 0.0f;
+            // Random stop duration between .5 and 3.5 seconds
+            agents.stopDuration[i] = 0.5f + std::floor(randomValues[i] * 4.0f);
+            agents.timeStopped[i] = 0.0f;
+        }
+
+        // Check for collisions with the environment
+        Hitbox newHitbox(newPosition + COW_BOX_MIN, newPosition + COW_BOX_MAX);
+
+        bool collision = world.overlapsAny(newHitbox, COLLISION_ENVIRONMENT);
+
+        // Check for collisions with the walls
+        uint32_t wall = world.firstOverlap(newHitbox, COLLISION_WALL);
+        bool wallCollision = wall != UINT32_MAX;
+        if (wallCollision) {
+            const Hitbox& wallHitbox = world.getBox(wall);
+
+            // Bounce on the X-axis and clamp the cow position to stay within the wall
+            agents.dirX[i] = -agents.dirX[i];
+            agents.posX[i] = agents.dirX[i] > 0 ? wallHitbox.maxCorner.x + 1.0f : wallHitbox.minCorner.x - 1.0f;
+
+            // Bounce on the Z-axis and clamp the cow position to stay within the wall
+            agents.dirZ[i] = -agents.dirZ[i];
+            agents.posZ[i] = agents.dirZ[i] > 0 ? wallHitbox.maxCorner.z + 1.0f : wallHitbox.minCorner.z - 1.0f;
+        }
+
+        // If no collision detected, update position; otherwise, bounce off the wall
+        if (!collision && !wallCollision) {
+            agents.posX[i] = newPosition.x;
+            agents.posY[i] = newPosition.y;
+            agents.posZ[i] = newPosition.z;
+        } else if (wallCollision) {
+            speed *= 0.5f; // Reduce speed when bouncing off the wall
+        } else {
+            speed = 0.0f;  // Stop the cow
+        }
+    } else {
+        // Decelerate the cow smoothly when stopping
+        agents.speed[i] = std::max(0.0f, agents.speed[i] - COW_DECELERATION * deltaTime);
+
+        // Check if the cow has stopped long enough
+        agents.timeStopped[i] += deltaTime;
+        if (agents.timeStopped[i] >= agents.stopDuration[i]) {
+            stopAndRotate(i); // Rotate and start moving again
+        } else if (agents.speed[i] == 0.0f) {
+            // Standing still with only the timer left, sleep until it runs out
+            uint32_t ticksLeft = AgentActivity::ticksUntil(agents.stopDuration[i] - agents.timeStopped[i], deltaTime);
+            if (ticksLeft > 1) activity.sleep(agents, static_cast<uint32_t>(i), tick, tick + ticksLeft);
+        }
+    }
+}
+
+void CowSystem::stopAndRotate(size_t i) {
+    // Rotate randomly by 45 degrees clockwise or counterclockwise
+    agents.targetRotation[i] = randomValues[i] < 0.5f ? 45.0f : -45.0f;
+    agents.flags[i] |= AGENT_ROTATING;
+}
+
+void CowSystem::capture() {
+    transforms.back().capture(agents);
+}
+
+void CowSystem::publish() {
+    transforms.publish();
+}
+
+void CowSystem::draw(Shader& shader, Model& model, const glm::mat4& view, const glm::mat4& projection, float alpha) {
+    // Only the published snapshot is read here, never the arrays the simulation writes
+    drawAgents(transforms.front(), shader, model, view, projection, alpha, COW_MODEL_SCALE);
+}
+
+// Knockback logic
+void CowSystem::gameHit(size_t i, glm::vec3 hitDirection, float carSpeed) {
+    activity.wake(agents, static_cast<uint32_t>(i), tick, tickDelta);
+
+    // Apply knockback based on the car's direction and speed, along the ground plane
+    glm::vec3 knockbackVelocity = glm::normalize(hitDirection) * carSpeed * COW_KNOCKBACK_MULTIPLIER;
+    agents.velX[i] = knockbackVelocity.x;
+    agents.velZ[i] = knockbackVelocity.z;
+    agents.flags[i] |= AGENT_HIT;
+
+    LOG_INFO("Cow hit! Knockback velocity: {}, {}, {}", knockbackVelocity.x, knockbackVelocity.y, knockbackVelocity.z);
+}
+
+bool CowSystem::getCowHit(size_t i) const {
+    return agents.flags[i] & AGENT_HIT;
+}
+
+float CowSystem::getSpeed(size_t i) const {
+    return agents.speed[i];
+}
@@ -0,0 +1,181 @@
+#include "EntityStore.h"
+#include <cassert>
+
+// Apply the same operation to every per-agent array
+template <typename Fn>
+static void forEachColumn(AgentStore& store, Fn&& fn) {
+    fn(store.posX); fn(store.posY); fn(store.posZ);
+    fn(store.prevPosX); fn(store.prevPosY); fn(store.prevPosZ);
+    fn(store.dirX); fn(store.dirZ);
+    fn(store.velX); fn(store.velZ);
+    fn(store.speed);
+    fn(store.totalRotation);
+    fn(store.prevRotation);
+    fn(store.targetRotation);
+    fn(store.distanceTraveled);
+    fn(store.stopDuration);
+    fn(store.timeStopped);
+    fn(store.flags);
+    fn(store.minX); fn(store.minY); fn(store.minZ);
+    fn(store.maxX); fn(store.maxY); fn(store.maxZ);
+}
+
+AgentHandle AgentStore::spawn(const glm::vec3& position) {
+    uint32_t index = static_cast<uint32_t>(size());
+
+    // Grow every column by one zeroed element
+    forEachColumn(*this, [](auto& column) { column.emplace_back(); });
+    posX[index] = position.x;
+    posY[index] = position.y;
+    posZ[index] = position.z;
+    prevPosX[index] = position.x;
+    prevPosY[index] = position.y;
+    prevPosZ[index] = position.z;
+    dirZ[index] = -1.0f;
+
+    uint32_t slot = allocateSlot(index);
+    return AgentHandle{slot, generations[slot]};
+}
+
+size_t AgentStore::spawnMany(const std::vector<glm::vec3>& positions) {
+    size_t first = size();
+    size_t count = positions.size();
+    reserve(first + count);
+
+    // Grow every column once for the whole batch
+    forEachColumn(*this, [first, count](auto& column) { column.resize(first + count); });
+    for (size_t i = 0; i < count; i++) {
+        size_t index = first + i;
+        posX[index] = prevPosX[index] = positions[i].x;
+        posY[index] = prevPosY[index] = positions[i].y;
+        posZ[index] = prevPosZ[index] = positions[i].z;
+        dirZ[index] = -1.0f;
+        allocateSlot(static_cast<uint32_t>(index));
+    }
+    return first;
+}
+
+uint32_t AgentStore::allocateSlot(uint32_t index) {
+    // Reuse a free slot if there is one, otherwise open a new one
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(slotToIndex.size());
+        slotToIndex.push_back(0);
+        generations.push_back(0);
+    }
+    slotToIndex[slot] = index;
+    indexToSlot.push_back(slot);
+    return slot;
+}
+
+void AgentStore::remove(AgentHandle handle) {
+    if (!isValid(handle)) return;
+
+    uint32_t index = slotToIndex[handle.slot];
+    uint32_t last = static_cast<uint32_t>(size() - 1);
+
+    // Move the last agent into the hole so the arrays stay packed
+    forEachColumn(*this, [index, last](auto& column) {
+        column[index] = column[last];
+        column.pop_back();
+    });
+    uint32_t movedSlot = indexToSlot[last];
+    indexToSlot[index] = movedSlot;
+    slotToIndex[movedSlot] = index;
+    indexToSlot.pop_back();
+
+    // Invalidate the removed handle
+    generations[handle.slot]++;
+    freeSlots.push_back(handle.slot);
+}
+
+bool AgentStore::isValid(AgentHandle handle) const {
+    return handle.slot < generations.size() && generations[handle.slot] == handle.generation
+        && slotToIndex[handle.slot] < size() && indexToSlot[slotToIndex[handle.slot]] == handle.slot;
+}
+
+size_t AgentStore::indexOf(AgentHandle handle) const {
+    assert(isValid(handle));
+    return slotToIndex[handle.slot];
+}
+
+AgentHandle AgentStore::handleAt(size_t index) const {
+    uint32_t slot = indexToSlot[index];
+    return AgentHandle{slot, generations[slot]};
+}
+
+void AgentStore::reserve(size_t count) {
+    forEachColumn(*this, [count](auto& column) { column.reserve(count); });
+    indexToSlot.reserve(count);
+    slotToIndex.reserve(count);
+    generations.reserve(count);
+}
+
+void AgentStore::clear() {
+    // Invalidate every live handle before dropping the agents
+    for (uint32_t slot : indexToSlot) {
+        generations[slot]++;
+        freeSlots.push_back(slot);
+    }
+    forEachColumn(*this, [](auto& column) { column.clear(); });
+    indexToSlot.clear();
+}
+
+glm::vec3 AgentStore::getPosition(size_t index) const {
+    return glm::vec3(posX[index], posY[index], posZ[index]);
+}
+
+Hitbox AgentStore::getHitbox(size_t index) const {
+    return Hitbox(glm::vec3(minX[index], minY[index], minZ[index]),
+                  glm::vec3(maxX[index], maxY[index], maxZ[index]));
+}
+
+void AgentStore::savePreviousState() {
+    prevPosX = posX;
+    prevPosY = posY;
+    prevPosZ = posZ;
+    prevRotation = totalRotation;
+}
+
+void AgentStore::savePreviousState(const std::vector<uint32_t>& indices) {
+    for (uint32_t i : indices) {
+        prevPosX[i] = posX[i];
+        prevPosY[i] = posY[i];
+        prevPosZ[i] = posZ[i];
+        prevRotation[i] = totalRotation[i];
+    }
+}
+
+void AgentStore::refreshBounds(size_t begin, size_t end, const glm::vec3& localMin, const glm::vec3& localMax) {
+    // Plain loops over separate arrays so the compiler can vectorise them
+    for (size_t i = begin; i < end; i++) {
+        minX[i] = posX[i] + localMin.x;
+        minY[i] = posY[i] + localMin.y;
+        minZ[i] = posZ[i] + localMin.z;
+        maxX[i] = posX[i] + localMax.x;
+        maxY[i] = posY[i] + localMax.y;
+        maxZ[i] = posZ[i] + localMax.z;
+    }
+}
+
+void AgentStore::resetAgent(size_t i, const glm::vec3& position, const glm::vec3& localMin, const glm::vec3& localMax) {
+    posX[i] = prevPosX[i] = position.x;
+    posY[i] = prevPosY[i] = position.y;
+    posZ[i] = prevPosZ[i] = position.z;
+    dirX[i] = 0.0f;
+    dirZ[i] = -1.0f;
+    velX[i] = 0.0f;
+    velZ[i] = 0.0f;
+    speed[i] = 0.0f;
+    totalRotation[i] = 0.0f;
+    prevRotation[i] = 0.0f;
+    targetRotation[i] = 0.0f;
+    distanceTraveled[i] = 0.0f;
+    stopDuration[i] = 0.0f;
+    timeStopped[i] = 0.0f;
+    flags[i] = AGENT_MOVING;
+    refreshBounds(i, i + 1, localMin, localMax);
+}
@@ -0,0 +1,89 @@
+// EntityStore.h
+// Packed storage for the cows and giraffes. Every agent is a column index into a set of
+// parallel arrays, so systems can walk one attribute at a time instead of whole objects.
+
+#ifndef ENTITY_STORE_H
+#define ENTITY_STORE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+#include "hitbox.hpp"
+
+// Handle to an agent. Stays valid while other agents are spawned or removed,
+// and goes stale once its own agent is removed.
+struct AgentHandle {
+    uint32_t slot = UINT32_MAX;   // Index into the handle table
+    uint32_t generation = 0;      // Bumped every time the slot is reused
+};
+
+// Bit flags stored per agent
+enum AgentFlags : uint8_t {
+    AGENT_MOVING       = 1 << 0,  // Walking forward
+    AGENT_ROTATING     = 1 << 1,  // Turning towards targetRotation
+    AGENT_HIT          = 1 << 2,  // Cow was hit by the car and can score points
+    AGENT_KNOCKED_DOWN = 1 << 3,  // Giraffe is lying down
+    AGENT_SLEEPING     = 1 << 4,  // Idle and skipped by the updates, see AgentActivity
+};
+
+class AgentStore {
+public:
+    // Per-agent state, index i of every array belongs to the same agent
+    std::vector<float> posX, posY, posZ;      // World position
+    std::vector<float> prevPosX, prevPosY, prevPosZ;  // Position at the start of the tick
+    std::vector<float> dirX, dirZ;            // Facing direction on the ground plane
+    std::vector<float> velX, velZ;            // Knockback velocity on the ground plane
+    std::vector<float> speed;                 // Walking speed
+    std::vector<float> totalRotation;         // Heading applied to the model (degrees)
+    std::vector<float> prevRotation;          // Heading at the start of the tick
+    std::vector<float> targetRotation;        // Rotation still left to apply (degrees)
+    std::vector<float> distanceTraveled;      // Distance walked since the last stop
+    std::vector<float> stopDuration;          // How long the agent stays stopped
+    std::vector<float> timeStopped;           // How long the agent has been stopped
+    std::vector<uint8_t> flags;               // AgentFlags
+
+    // World-space bounds, refreshed by the systems after every update
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+
+    // Add an agent at the given position with zeroed state
+    AgentHandle spawn(const glm::vec3& position);
+    // Add one agent per position in a single pass, returns the index of the first one
+    size_t spawnMany(const std::vector<glm::vec3>& positions);
+    // Remove an agent, the last agent is moved into its index
+    void remove(AgentHandle handle);
+    bool isValid(AgentHandle handle) const;
+    // Dense array index of a live agent
+    size_t indexOf(AgentHandle handle) const;
+    AgentHandle handleAt(size_t index) const;
+    // Stable id of every agent in index order (its handle slot), e.g. to key random numbers
+    const uint32_t* ids() const { return indexToSlot.data(); }
+
+    void reserve(size_t count);
+    void clear();
+    size_t size() const { return posX.size(); }
+
+    glm::vec3 getPosition(size_t index) const;
+    Hitbox getHitbox(size_t index) const;
+
+    // Remember the current transforms before a tick changes them
+    void savePreviousState();
+    // Same for the listed agents only
+    void savePreviousState(const std::vector<uint32_t>& indices);
+    // Recompute the bounds of agents [begin, end) from their positions and a local box
+    void refreshBounds(size_t begin, size_t end, const glm::vec3& localMin, const glm::vec3& localMax);
+    // Put an agent back to a fresh state at 'position': walking, facing -Z, nothing else set
+    void resetAgent(size_t index, const glm::vec3& position, const glm::vec3& localMin, const glm::vec3& localMax);
+
+private:
+    std::vector<uint32_t> slotToIndex;   // Handle slot -> dense index
+    std::vector<uint32_t> indexToSlot;   // Dense index -> handle slot
+    std::vector<uint32_t> generations;   // Current generation of every slot
+    std::vector<uint32_t> freeSlots;     // Slots available for reuse
+
+    // Give the agent at 'index' a handle slot
+    uint32_t allocateSlot(uint32_t index);
+};
+
+#endif // ENTITY_STORE_H
@@ -1,12 +1,11 @@
 #include <glad/glad.h>
 #include "ExhaustSystem.h"
 #include <glm/gtc/matrix_transform.hpp>
-#include <random>
 #include "texture_loader.h"
 
 // Constructor
 ExhaustSystem::ExhaustSystem(int maxParticles, glm::vec3 exhaustPosition)
-    : maxParticles(maxParticles), exhaustPosition(exhaustPosition) {
+    : maxParticles(maxParticles), exhaustPosition(exhaustPosition), random(deriveSeed(RANDOM_STREAM_EXHAUST, 0)) {
     particles.reserve(maxParticles);
 }
 
@@ -31,13 +30,10 @@ void ExhaustSystem::update(float deltaTime, const glm::vec3& carPosition) {
 
 // Emit new particles from the exhaust
 void ExhaustSystem::emitParticles(const glm::vec3& carPosition) {
-    static std::default_random_engine generator;
-    static std::uniform_real_distribution<float> randomFloat(-0.1f, 0.1f);
-
     if (particles.size() < maxParticles) {
         Smoke particle;
         particle.position = carPosition + exhaustPosition;  // Emit from the exhaust pipe
-        particle.velocity = glm::vec3(randomFloat(generator), 0.2f, randomFloat(generator));  // Random upward velocity
+        particle.velocity = glm::vec3(random.range(-0.1f, 0.1f), 0.2f, random.range(-0.1f, 0.1f));  // Random upward velocity
         particle.lifetime = 2.0f;  // Smoke lasts 2 seconds
         particle.size = 0.1f;      // Start with small size
         particle.alpha = 0.5f;     // Fully opaque at first
@@ -46,9 +42,14 @@ void ExhaustSystem::emitParticles(const glm::vec3& carPosition) {
     }
 }
 
+void ExhaustSystem::setTexture(unsigned int textureID) {
+    smokeTextureID = textureID;
+}
+
 // Render the particles
 void ExhaustSystem::render(Shader& shader, const glm::mat4& view, const glm::mat4& projection) {
-    unsigned int smokeTextureID = loadTexture("src/smoke-img_trans.png");
+    // The smoke texture streams in after the game assets, draw nothing until it is there
+    if (smokeTextureID == 0) return;
 
     // Enable blending and disable depth writing
     glEnable(GL_BLEND);
@@ -57,6 +58,7 @@ void ExhaustSystem::render(Shader& shader, const glm::mat4& view, const glm::mat
 
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, smokeTextureID);
+    renderStats.textureBinds++;
     shader.setInt("particleTexture", 0);  // Set the texture unit 0
 
     for (const auto& particle : particles) {
@@ -118,6 +120,7 @@ void ExhaustSystem::renderQuad() {
     // Bind VAO and draw the quad
     glBindVertexArray(quadVAO);
     glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+    renderStats.addDraw(2);
 
     // Unbind VAO after rendering
     glBindVertexArray(0);
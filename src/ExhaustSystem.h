@@ -4,7 +4,7 @@
 #include <vector>
 #include <glm/glm.hpp>
 #include "shader.h"
-#include <random>
+#include "Random.h"
 #include "texture_loader.h"
 
 struct Smoke {
@@ -26,8 +26,14 @@ public:
     void update(float deltaTime, const glm::vec3& carPosition);
     void emitParticles(const glm::vec3& carPosition);
     void render(Shader& shader, const glm::mat4& view, const glm::mat4& projection);
+    // Smoke texture, uploaded by the asset loader
+    void setTexture(unsigned int textureID);
+    size_t liveParticles() const { return particles.size(); }
 
 private:
+    RandomStream random;  // Smoke spread, derived from the master seed
+    unsigned int smokeTextureID = 0;  // Nothing is drawn until it is set
+
     void renderQuad();  // Function to render a quad or particle texture
 };
 
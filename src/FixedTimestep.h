@@ -0,0 +1,50 @@
+// FixedTimestep.h
+// Accumulates real frame time and hands it out as fixed simulation ticks, so the
+// simulation advances by the same step whatever the render frame rate is.
+
+#ifndef FIXED_TIMESTEP_H
+#define FIXED_TIMESTEP_H
+
+#include <algorithm>
+#include <cstdint>
+
+class FixedTimestep {
+public:
+    // tickRate: simulation ticks per second (e.g. 60 or 120)
+    // maxTicksPerFrame: upper bound on catch-up ticks, excess time is dropped
+    // maxFrameTime: longest frame time accepted, longer hitches are clamped
+    FixedTimestep(double tickRate = 60.0, int maxTicksPerFrame = 8, double maxFrameTime = 0.25)
+        : tickLength(1.0 / tickRate), maxTicksPerFrame(maxTicksPerFrame), maxFrameTime(maxFrameTime) {}
+
+    // Add the time since the last frame, returns how many ticks should run this frame
+    int advance(double frameTime) {
+        accumulator += std::min(std::max(frameTime, 0.0), maxFrameTime);
+
+        int ticks = static_cast<int>(accumulator / tickLength);
+        if (ticks > maxTicksPerFrame) {
+            // Too far behind: run what we can and drop the rest instead of spiralling
+            ticks = maxTicksPerFrame;
+            accumulator = tickLength * ticks;
+        }
+        accumulator -= tickLength * ticks;
+        tickCount += ticks;
+        return ticks;
+    }
+
+    // Forget any pending time, e.g. when gameplay starts or restarts
+    void reset() { accumulator = 0.0; }
+
+    float tickDelta() const { return static_cast<float>(tickLength); }
+    // How far the render time is between the previous and the current tick, in [0, 1)
+    float alpha() const { return static_cast<float>(accumulator / tickLength); }
+    uint64_t ticks() const { return tickCount; }
+
+private:
+    double tickLength;
+    int maxTicksPerFrame;
+    double maxFrameTime;
+    double accumulator = 0.0;
+    uint64_t tickCount = 0;
+};
+
+#endif // FIXED_TIMESTEP_H
@@ -0,0 +1,75 @@
+#include "FrameArena.h"
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+
+// Heap blocks for overflowing requests that can be released in reset()
+static const size_t MAX_OVERFLOW_BLOCKS = 64;
+
+FrameArena::FrameArena(size_t capacity) : buffer(capacity) {
+    overflow.reserve(MAX_OVERFLOW_BLOCKS);
+}
+
+FrameArena::~FrameArena() {
+    reset();
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment) {
+    uintptr_t base = reinterpret_cast<uintptr_t>(buffer.data());
+    uintptr_t aligned = (base + offset + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    size_t start = static_cast<size_t>(aligned - base);
+    requested += size + alignment - 1;
+
+    if (start + size <= buffer.size()) {
+        offset = start + size;
+        return buffer.data() + start;
+    }
+
+    // Does not fit this frame, reset() makes room for next time
+    if (overflow.size() == MAX_OVERFLOW_BLOCKS) throw std::bad_alloc();
+    void* block = ::operator new(size, std::align_val_t(alignment));
+    overflow.push_back(OverflowBlock{block, alignment});
+    return block;
+}
+
+const char* FrameArena::format(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    va_list retry;
+    va_copy(retry, args);
+
+    // Format straight into the free space, and only allocate exactly when it is too small
+    size_t space = buffer.size() - offset;
+    char* text = reinterpret_cast<char*>(buffer.data() + offset);
+    int length = std::vsnprintf(text, space, fmt, args);
+    va_end(args);
+
+    if (length < 0) {
+        va_end(retry);
+        return "";
+    }
+    if (static_cast<size_t>(length) < space) {
+        offset += length + 1;
+        requested += length + 1;
+    } else {
+        text = static_cast<char*>(allocate(length + 1, 1));
+        std::vsnprintf(text, length + 1, fmt, retry);
+    }
+    va_end(retry);
+    return text;
+}
+
+void FrameArena::reset() {
+    for (const OverflowBlock& block : overflow) {
+        ::operator delete(block.memory, std::align_val_t(block.alignment));
+    }
+    if (peak < requested) peak = requested;
+
+    // Grow to the largest frame so far, once overflow showed the buffer is too small
+    if (!overflow.empty() && buffer.size() < peak) {
+        buffer.resize(peak);
+    }
+    overflow.clear();
+    offset = 0;
+    requested = 0;
+}
@@ -0,0 +1,51 @@
+// FrameArena.h
+// Linear allocator for data that only lives for one frame, like formatted HUD text.
+// Allocating bumps an offset and reset() at the start of the next frame frees it all.
+// Requests that do not fit go to the heap for that frame, and the next reset() grows the
+// buffer so a steady-state frame is served from it without touching the heap.
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+class FrameArena {
+public:
+    explicit FrameArena(size_t capacity = 64 * 1024);
+    ~FrameArena();
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Uninitialised memory valid until the next reset()
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T* allocateArray(size_t count) {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // printf-style formatting into arena memory, the string is valid until the next reset()
+    const char* format(const char* fmt, ...);
+
+    // Free everything allocated this frame
+    void reset();
+
+    size_t used() const { return offset; }
+    size_t capacity() const { return buffer.size(); }
+    size_t highWater() const { return peak; }  // Most bytes a single frame has asked for
+
+private:
+    std::vector<unsigned char> buffer;
+    size_t offset = 0;
+    size_t requested = 0;             // Bytes asked for this frame, including overflow
+    size_t peak = 0;
+    struct OverflowBlock {
+        void* memory;
+        size_t alignment;
+    };
+    std::vector<OverflowBlock> overflow;  // Heap blocks for requests that did not fit
+};
+
+#endif // FRAME_ARENA_H
@@ -0,0 +1,139 @@
+#include "GameConfig.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+// Spacing between animals in stress mode, just wider than their hitboxes
+static const float STRESS_SPACING = 2.5f;
+// Poisson-disk samples fit about 0.6 points per spacing squared, leave room for twice the agents
+static const float STRESS_AREA_PER_AGENT = 2.0f / 0.6f;
+
+static std::string trim(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) return "";
+    size_t last = text.find_last_not_of(" \t\r\n");
+    return text.substr(first, last - first + 1);
+}
+
+static bool parseInt(const std::string& value, int& out) {
+    char* end = nullptr;
+    long parsed = std::strtol(value.c_str(), &end, 10);
+    if (end == value.c_str() || *end != '\0' || parsed < 0) return false;
+    out = static_cast<int>(parsed);
+    return true;
+}
+
+static bool parseFloat(const std::string& value, float& out) {
+    char* end = nullptr;
+    float parsed = std::strtof(value.c_str(), &end);
+    if (end == value.c_str() || *end != '\0' || parsed <= 0.0f) return false;
+    out = parsed;
+    return true;
+}
+
+// Size the map so the stress crowd fits with the stress spacing
+static void applyStressMode(GameConfig& config) {
+    int agents = config.stressAgents;
+    config.cowCount = agents / 2;
+    config.giraffeCount = agents - agents / 2;
+    config.animalSpacing = STRESS_SPACING;
+
+    float side = STRESS_SPACING * std::sqrt(agents * STRESS_AREA_PER_AGENT);
+    config.animalRange = std::max(config.animalRange, side * 0.5f);
+    config.objectRange = std::max(config.objectRange, config.animalRange);
+}
+
+bool applyConfigOption(const std::string& key, const std::string& value, GameConfig& config) {
+    bool valid = true;
+    if (key == "cows") valid = parseInt(value, config.cowCount);
+    else if (key == "giraffes") valid = parseInt(value, config.giraffeCount);
+    else if (key == "trees") valid = parseInt(value, config.treeCount);
+    else if (key == "big-rocks") valid = parseInt(value, config.bigRockCount);
+    else if (key == "small-rocks") valid = parseInt(value, config.smallRockCount);
+    else if (key == "animal-range") valid = parseFloat(value, config.animalRange);
+    else if (key == "animal-spacing") valid = parseFloat(value, config.animalSpacing);
+    else if (key == "object-range") valid = parseFloat(value, config.objectRange);
+    else if (key == "object-spacing") valid = parseFloat(value, config.objectSpacing);
+    else if (key == "tick-rate") {
+        float tickRate;
+        valid = parseFloat(value, tickRate);
+        if (valid) config.tickRate = tickRate;
+    } else if (key == "seed") {
+        char* end = nullptr;
+        config.seed = std::strtoull(value.c_str(), &end, 10);
+        valid = end != value.c_str() && *end == '\0';
+        config.hasSeed = valid;
+    } else if (key == "serial") {
+        int serial;
+        valid = parseInt(value, serial);
+        if (valid) config.serialSimulation = serial != 0;
+    } else if (key == "check-allocations") {
+        int check;
+        valid = parseInt(value, check);
+        if (valid) config.checkAllocations = check != 0;
+    } else if (key == "profile") {
+        valid = parseInt(value, config.profileFrames);
+    } else if (key == "overlay") {
+        int overlay;
+        valid = parseInt(value, overlay);
+        if (valid) config.showOverlay = overlay != 0;
+    } else if (key == "stress") {
+        valid = parseInt(value, config.stressAgents);
+        if (valid && config.isStress()) applyStressMode(config);
+    } else if (key == "config") {
+        return loadConfigFile(value, config);
+    } else {
+        std::cout << "Unknown option: " << key << std::endl;
+        return false;
+    }
+
+    if (!valid) std::cout << "Invalid value for " << key << ": " << value << std::endl;
+    return valid;
+}
+
+bool loadConfigFile(const std::string& path, GameConfig& config) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cout << "Failed to open config file: " << path << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+    std::string line;
+    while (std::getline(file, line)) {
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            std::cout << "Ignoring config line without '=': " << line << std::endl;
+            ok = false;
+            continue;
+        }
+        ok &= applyConfigOption(trim(line.substr(0, equals)), trim(line.substr(equals + 1)), config);
+    }
+    return ok;
+}
+
+bool parseGameConfig(int argc, char** argv, GameConfig& config) {
+    bool ok = true;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0) {
+            std::cout << "Ignoring argument: " << arg << std::endl;
+            ok = false;
+            continue;
+        }
+
+        size_t equals = arg.find('=');
+        if (equals == std::string::npos) {
+            std::cout << "Option needs a value (--key=value): " << arg << std::endl;
+            ok = false;
+            continue;
+        }
+        ok &= applyConfigOption(arg.substr(2, equals - 2), arg.substr(equals + 1), config);
+    }
+    return ok;
+}
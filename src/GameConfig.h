@@ -0,0 +1,57 @@
+// GameConfig.h
+// Entity counts, map size and spacing for a run. The defaults are the normal game, and
+// every value can be changed from the command line (--key=value) or from a config file
+// (--config=path) with one key=value per line.
+
+#ifndef GAME_CONFIG_H
+#define GAME_CONFIG_H
+
+#include <cstdint>
+#include <string>
+
+struct GameConfig {
+    int cowCount = 20;
+    int giraffeCount = 50;
+    int treeCount = 10;
+    int bigRockCount = 15;
+    int smallRockCount = 30;
+
+    float animalRange = 70.0f;     // Animals spawn in [-range, range] on X and Z
+    float animalSpacing = 5.0f;    // Minimum distance between two animals
+    float objectRange = 90.0f;     // Same for trees and rocks
+    float objectSpacing = 15.0f;
+
+    double tickRate = 60.0;        // Simulation ticks per second
+    uint64_t seed = 0;             // Master random seed
+    bool hasSeed = false;          // False: a seed is taken from the clock
+
+    // Run the simulation on the GL thread before rendering instead of pipelined on a worker,
+    // useful for debugging
+    bool serialSimulation = false;
+
+    // Abort when the in-game loop allocates from the heap after warming up
+    bool checkAllocations = false;
+
+    // Profile this many game frames once warmed up and write them to profile.json
+    int profileFrames = 0;
+
+    // Start with the performance overlay shown, F3 toggles it in game
+    bool showOverlay = false;
+
+    // Stress mode: spawn this many animals on a map sized to fit them and report timings
+    int stressAgents = 0;
+
+    bool isStress() const { return stressAgents > 0; }
+};
+
+// Read the command line into 'config'. Later options override earlier ones,
+// including values loaded from a --config file. Returns false on a bad option.
+bool parseGameConfig(int argc, char** argv, GameConfig& config);
+
+// Apply one key/value pair, keys are the option names without the leading dashes
+bool applyConfigOption(const std::string& key, const std::string& value, GameConfig& config);
+
+// Load key=value lines from a file, '#' starts a comment
+bool loadConfigFile(const std::string& path, GameConfig& config);
+
+#endif // GAME_CONFIG_H
@@ -0,0 +1,194 @@
+#include "GiraffeSystem.h"
+#include "AgentDraw.h"
+#include "ParallelFor.h"
+#include "Random.h"
+#include "Log.h"
+#include "Profiler.h"
+#include <cmath>
+
+// Movement tuning shared by every giraffe
+static const float GIRAFFE_ROTATION_SPEED = 20.0f;   // Degrees per second while turning
+static const float GIRAFFE_KNOCKDOWN_SPEED = 200.0f; // Degrees per second while falling
+static const float GIRAFFE_KNOCKDOWN_ANGLE = 90.0f;  // How far a giraffe turns when knocked down
+static const float GIRAFFE_KNOCKBACK_MULTIPLIER = 5.0f;
+static const glm::vec3 GIRAFFE_BOX_MIN(-1.0f, 0.0f, -1.0f);
+static const glm::vec3 GIRAFFE_BOX_MAX(1.0f, 2.0f, 1.0f);
+static const float GIRAFFE_MODEL_SCALE = 0.2f;  // Size the model is drawn at
+
+// Giraffes per worker chunk, smaller herds are updated on the calling thread
+static const size_t GIRAFFE_CHUNK = 256;
+
+GiraffeSystem::GiraffeSystem(size_t capacity, uint64_t seed) : seed(seed), randomKey(counterKey(seed, 0)) {
+    agents.reserve(capacity);
+    activity.reserve(capacity);
+}
+
+AgentHandle GiraffeSystem::spawn(const glm::vec3& position) {
+    AgentHandle handle = agents.spawn(position);
+    size_t index = agents.indexOf(handle);
+    agents.resetAgent(index, position, GIRAFFE_BOX_MIN, GIRAFFE_BOX_MAX);
+    activity.add(static_cast<uint32_t>(index));
+    return handle;
+}
+
+size_t GiraffeSystem::spawnMany(const std::vector<glm::vec3>& positions) {
+    activity.reserve(agents.size() + positions.size());
+    size_t first = agents.spawnMany(positions);
+    for (size_t i = 0; i < positions.size(); i++) {
+        agents.resetAgent(first + i, positions[i], GIRAFFE_BOX_MIN, GIRAFFE_BOX_MAX);
+        activity.add(static_cast<uint32_t>(first + i));
+    }
+    return first;
+}
+
+void GiraffeSystem::reset(const std::vector<glm::vec3>& positions) {
+    // New round, so the agents do not replay the random choices of the last game
+    resetCount++;
+    randomKey = counterKey(seed, resetCount);
+    for (size_t i = 0; i < agents.size() && i < positions.size(); ++i) {
+        agents.resetAgent(i, positions[i], GIRAFFE_BOX_MIN, GIRAFFE_BOX_MAX);
+    }
+    activity.reset(agents.size());
+    capture();
+    publish();
+}
+
+void GiraffeSystem::update(float deltaTime) {
+    tick++;
+    tickDelta = deltaTime;
+    randomValues.resize(agents.size());
+
+    // Wake the giraffes whose wait runs out and drop the ones that fell asleep
+    activity.beginTick(agents, tick, deltaTime);
+    const std::vector<uint32_t>& awake = activity.awake();
+
+    parallelFor(awake.size(), GIRAFFE_CHUNK, [&](size_t begin, size_t end) {
+        PROFILE_ZONE("giraffe chunk");
+
+        // One random number per giraffe for this tick, keyed by the giraffe's id and the tick.
+        // The ids of the awake giraffes are gathered into blocks so each block is filled by one call.
+        for (size_t blockBegin = begin; blockBegin < end; blockBegin += GIRAFFE_CHUNK) {
+            size_t blockSize = std::min(GIRAFFE_CHUNK, end - blockBegin);
+            uint32_t blockIds[GIRAFFE_CHUNK];
+            float blockRandom[GIRAFFE_CHUNK];
+            for (size_t k = 0; k < blockSize; k++) blockIds[k] = agents.ids()[awake[blockBegin + k]];
+            fillEntityRandom(randomKey, tick, blockIds, blockSize, blockRandom);
+            for (size_t k = 0; k < blockSize; k++) randomValues[awake[blockBegin + k]] = blockRandom[k];
+        }
+
+        for (size_t k = begin; k < end; k++) {
+            uint32_t i = awake[k];
+
+            // If giraffe is knocked down, don't allow normal movement
+            if (agents.flags[i] & AGENT_KNOCKED_DOWN) continue;
+
+            moveRandomly(i, deltaTime);
+
+            // Update the giraffe's hitbox position
+            agents.refreshBounds(i, i + 1, GIRAFFE_BOX_MIN, GIRAFFE_BOX_MAX);
+        }
+    });
+}
+
+void GiraffeSystem::moveRandomly(size_t i, float deltaTime) {
+    uint8_t& flags = agents.flags[i];
+
+    if (flags & AGENT_ROTATING) {
+        flags |= AGENT_MOVING;
+
+        // Smoothly rotate towards the target angle
+        float rotationStep = GIRAFFE_ROTATION_SPEED * deltaTime;
+        float& target = agents.targetRotation[i];
+
+        if (std::fabs(target) > rotationStep) {
+            agents.totalRotation[i] += (target > 0 ? rotationStep : -rotationStep);
+            target -= (target > 0 ? rotationStep : -rotationStep);
+        } else {
+            agents.totalRotation[i] += target;
+            target = 0.0f;
+            flags &= ~AGENT_ROTATING;
+
+            // Forward direction is +Z rotated around the Y axis
+            float radians = glm::radians(agents.totalRotation[i]);
+            agents.dirX[i] = std::sin(radians);
+            agents.dirZ[i] = std::cos(radians);
+        }
+    }
+
+    if (flags & AGENT_MOVING) {
+        // Giraffes do not walk, they stop straight away and wait before turning again
+        flags &= ~AGENT_MOVING;
+        agents.distanceTraveled[i] = 0.0f;
+        agents.stopDuration[i] = 0.5f + std::floor(randomValues[i] * 4.0f);
+        agents.timeStopped[i] = 0.0f;
+    } else {
+        agents.timeStopped[i] += deltaTime;
+        if (agents.timeStopped[i] >= agents.stopDuration[i]) {
+            stopAndRotate(i);
+        } else {
+            // Nothing to do but wait, sleep until the wait is over
+            uint32_t ticksLeft = AgentActivity::ticksUntil(agents.stopDuration[i] - agents.timeStopped[i], deltaTime);
+            if (ticksLeft > 1) activity.sleep(agents, static_cast<uint32_t>(i), tick, tick + ticksLeft);
+        }
+    }
+}
+
+void GiraffeSystem::stopAndRotate(size_t i) {
+    // Turn between 15 and 30 degrees either way
+    float angle = randomValues[i] * 30.0f - 15.0f;
+    agents.targetRotation[i] = angle + (angle < 0.0f ? -15.0f : 15.0f);
+    agents.flags[i] |= AGENT_ROTATING;
+}
+
+void GiraffeSystem::updateKnockdown(float deltaTime) {
+    float rotationStep = GIRAFFE_KNOCKDOWN_SPEED * deltaTime;
+
+    for (uint32_t i : activity.awake()) {
+        if (!(agents.flags[i] & AGENT_KNOCKED_DOWN)) continue;
+
+        // Smoothly rotate towards the target angle
+        float& target = agents.targetRotation[i];
+        if (std::fabs(target) > rotationStep) {
+            agents.totalRotation[i] += (target > 0 ? rotationStep : -rotationStep);
+            target -= (target > 0 ? rotationStep : -rotationStep);
+        } else {
+            agents.totalRotation[i] += target;
+            target = 0.0f;
+
+            // Lying still for good, nothing wakes it again this round
+            activity.sleep(agents, i, tick, AgentActivity::NO_TIMER);
+        }
+    }
+}
+
+void GiraffeSystem::capture() {
+    transforms.back().capture(agents);
+}
+
+void GiraffeSystem::publish() {
+    transforms.publish();
+}
+
+void GiraffeSystem::draw(Shader& shader, Model& model, const glm::mat4& view, const glm::mat4& projection, float alpha) {
+    // Only the published snapshot is read here, never the arrays the simulation writes
+    drawAgents(transforms.front(), shader, model, view, projection, alpha, GIRAFFE_MODEL_SCALE);
+}
+
+// Knockback logic
+void GiraffeSystem::gameHit(size_t i, glm::vec3 hitDirection, float cowSpeed, int& gameScore) {
+    if (agents.flags[i] & AGENT_KNOCKED_DOWN) return;
+    activity.wake(agents, static_cast<uint32_t>(i), tick, tickDelta);
+
+    gameScore++;
+
+    // Set the knockback velocity
+    glm::vec3 knockbackVelocity = glm::normalize(hitDirection) * cowSpeed * GIRAFFE_KNOCKBACK_MULTIPLIER;
+    agents.velX[i] = knockbackVelocity.x;
+    agents.velZ[i] = knockbackVelocity.z;
+
+    // Initiate knockdown effect and lay the giraffe down
+    agents.flags[i] = (agents.flags[i] | AGENT_KNOCKED_DOWN) & ~AGENT_ROTATING;
+    agents.targetRotation[i] = GIRAFFE_KNOCKDOWN_ANGLE;
+
+    LOG_INFO("Giraffe knocked down! Knockback velocity: {}, {}, {}", knockbackVelocity.x, knockbackVelocity.y, knockbackVelocity.z);
+}
@@ -0,0 +1,56 @@
+#ifndef GIRAFFE_SYSTEM_H
+#define GIRAFFE_SYSTEM_H
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "EntityStore.h"
+#include "TransformSnapshot.h"
+#include "AgentActivity.h"
+#include "model.hpp"
+#include "shader.h"
+#include "hitbox.hpp"
+
+// Runs the behaviour of every giraffe over the packed arrays in an AgentStore
+class GiraffeSystem {
+public:
+    AgentStore agents;
+    DoubleBuffer<AgentTransforms> transforms;  // What the renderer draws, see publish()
+    AgentActivity activity;                    // Which agents are awake this tick
+
+    // 'seed' drives every random choice of the giraffes, e.g. streamSeed(RANDOM_STREAM_GIRAFFES)
+    GiraffeSystem(size_t capacity = 0, uint64_t seed = 0);
+
+    AgentHandle spawn(const glm::vec3& position);
+    // Spawn one giraffe per position with storage reserved once, returns the index of the first
+    size_t spawnMany(const std::vector<glm::vec3>& positions);
+    void reset(const std::vector<glm::vec3>& positions);  // Put every giraffe back to a fresh state
+    size_t size() const { return agents.size(); }
+    size_t activeCount() const { return activity.awake().size(); }
+    size_t sleepingCount() const { return activity.sleeping().size(); }
+
+    // Stop, wait and turn on the spot for every giraffe that is standing
+    void update(float deltaTime);
+    // Play the fall animation of knocked down giraffes
+    void updateKnockdown(float deltaTime);
+    // Copy this tick's transforms into the back buffer (simulation side)
+    void capture();
+    // Flip the captured transforms to the front (render side, while the simulation is idle)
+    void publish();
+    // Draw the published transforms blended 'alpha' of the way from the previous to the current tick
+    void draw(Shader& shader, Model& model, const glm::mat4& view, const glm::mat4& projection, float alpha = 1.0f);
+
+    void gameHit(size_t index, glm::vec3 hitDirection, float cowSpeed, int& gameScore);  // Add knockback logic
+
+private:
+    uint64_t seed;                    // Seed every round's key is derived from
+    uint64_t resetCount = 0;          // Rounds played so far
+    uint64_t randomKey;               // Counter RNG key for this round
+    uint32_t tick = 0;                // Updates run so far, the counter of every draw
+    float tickDelta = 0.0f;           // Step of the last update, to catch up agents woken by a hit
+    std::vector<float> randomValues;  // This tick's random number of every giraffe
+
+    void moveRandomly(size_t index, float deltaTime);
+    void stopAndRotate(size_t index);
+};
+
+#endif // GIRAFFE_SYSTEM_H
@@ -0,0 +1,326 @@
+#include "GlyphCache.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+// Distance field settings. Pixels up to SDF_PADDING away from an edge get a distance,
+// the edge itself is stored as SDF_ON_EDGE.
+static const int SDF_PADDING = 5;
+static const unsigned char SDF_ON_EDGE = 128;
+static const float SDF_DISTANCE_SCALE = 128.0f / SDF_PADDING;
+
+// Cache file layout, raw structs since the file never leaves this machine
+static const char CACHE_MAGIC[4] = {'S', 'D', 'F', 'C'};
+static const uint32_t CACHE_VERSION = 2;
+struct CacheFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t fontHash;
+    float pixelHeight;
+    int32_t atlasSize;
+    int32_t nextShelfY;
+    uint32_t shelfCount;
+    uint32_t glyphCount;
+};
+
+GlyphCache::~GlyphCache() {
+    deleteTexture();
+}
+
+void GlyphCache::deleteTexture() {
+    if (atlasTexture != 0) glDeleteTextures(1, &atlasTexture);
+    atlasTexture = 0;
+}
+
+void GlyphCache::init(const stbtt_fontinfo* font, float pixelHeight) {
+    this->font = font;
+    this->pixelHeight = pixelHeight;
+    scale = stbtt_ScaleForPixelHeight(font, pixelHeight);
+
+    // Everything the cache grows into is sized here, adding glyphs later never allocates
+    pixels.assign(static_cast<size_t>(ATLAS_SIZE) * ATLAS_SIZE, 0);
+    shelves.clear();
+    shelves.reserve(ATLAS_SIZE / 2);
+    nextShelfY = 1;
+    glyphCount = 0;
+    rebuildTable();
+
+    glGenTextures(1, &atlasTexture);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, ATLAS_SIZE, ATLAS_SIZE, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+
+    // Linear filtering interpolates the distances, which is what keeps scaled edges smooth
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+const Character* GlyphCache::find(uint32_t codepoint) {
+    int index = table[findSlot(codepoint)];
+    if (index < 0) return nullptr;
+
+    Glyph& glyph = glyphs[index];
+    if (glyph.shelf >= 0) shelves[glyph.shelf].lastUsed = useStamp;
+    return &glyph.character;
+}
+
+const Character* GlyphCache::add(uint32_t codepoint) {
+    if (glyphCount == MAX_GLYPHS && !freeGlyphSlots()) return nullptr;
+
+    int width, height, xoff, yoff;
+    unsigned char* bitmap = stbtt_GetCodepointSDF(font, scale, static_cast<int>(codepoint), SDF_PADDING, SDF_ON_EDGE,
+                                                  SDF_DISTANCE_SCALE, &width, &height, &xoff, &yoff);
+    int advanceWidth, leftSideBearing;
+    stbtt_GetCodepointHMetrics(font, static_cast<int>(codepoint), &advanceWidth, &leftSideBearing);
+
+    Glyph glyph;
+    glyph.codepoint = codepoint;
+    glyph.shelf = -1;
+    glyph.origin = glm::ivec2(0);
+    glyph.live = true;
+    glyph.character = Character{glm::ivec2(0), glm::vec2(0.0f), advanceWidth * scale, glm::vec2(0.0f), glm::vec2(0.0f)};
+
+    // Glyphs without an outline, like space, keep only their advance
+    if (bitmap && width > 0 && height > 0 && width + 2 <= ATLAS_SIZE && height + 2 <= ATLAS_SIZE) {
+        int shelfIndex = placeShelf(width, height);
+        if (shelfIndex < 0) {
+            stbtt_FreeSDF(bitmap, NULL);
+            return nullptr;
+        }
+        Shelf& shelf = shelves[shelfIndex];
+        glyph.shelf = shelfIndex;
+        glyph.origin = glm::ivec2(shelf.usedWidth, shelf.y);
+        shelf.usedWidth += width + 1;
+        shelf.lastUsed = useStamp;
+
+        for (int row = 0; row < height; row++) {
+            std::memcpy(&pixels[static_cast<size_t>(glyph.origin.y + row) * ATLAS_SIZE + glyph.origin.x],
+                        bitmap + row * width, width);
+        }
+        uploadRegion(glyph.origin.x, glyph.origin.y, width, height);
+
+        // Bearing is measured from the pen position on the baseline to the top left of the
+        // padded bitmap
+        glyph.character.Size = glm::ivec2(width, height);
+        glyph.character.Bearing = glm::vec2(xoff, -yoff);
+        glyph.character.UvMin = glm::vec2(glyph.origin) / static_cast<float>(ATLAS_SIZE);
+        glyph.character.UvMax = glm::vec2(glyph.origin + glm::ivec2(width, height)) / static_cast<float>(ATLAS_SIZE);
+    }
+    stbtt_FreeSDF(bitmap, NULL);
+
+    size_t index = glyphCount++;
+    glyphs[index] = glyph;
+    table[findSlot(codepoint)] = static_cast<int16_t>(index);
+    return &glyphs[index].character;
+}
+
+float GlyphCache::advance(uint32_t codepoint) {
+    int index = table[findSlot(codepoint)];
+    if (index >= 0) return glyphs[index].character.Advance;
+
+    int advanceWidth, leftSideBearing;
+    stbtt_GetCodepointHMetrics(font, static_cast<int>(codepoint), &advanceWidth, &leftSideBearing);
+    return advanceWidth * scale;
+}
+
+int GlyphCache::findSlot(uint32_t codepoint) const {
+    int slot = static_cast<int>((codepoint * 2654435761u) & (TABLE_SIZE - 1));
+    while (table[slot] >= 0 && glyphs[table[slot]].codepoint != codepoint) {
+        slot = (slot + 1) & (TABLE_SIZE - 1);
+    }
+    return slot;
+}
+
+// Drop evicted glyphs, pack the live ones to the front and index them again
+void GlyphCache::rebuildTable() {
+    size_t live = 0;
+    for (size_t i = 0; i < glyphCount; i++) {
+        if (glyphs[i].live) glyphs[live++] = glyphs[i];
+    }
+    glyphCount = live;
+
+    std::fill(table, table + TABLE_SIZE, static_cast<int16_t>(-1));
+    for (size_t i = 0; i < glyphCount; i++) {
+        table[findSlot(glyphs[i].codepoint)] = static_cast<int16_t>(i);
+    }
+}
+
+int GlyphCache::placeShelf(int width, int height) {
+    // Best fit: the shortest shelf with room that is tall enough but not much taller
+    int best = -1;
+    for (size_t i = 0; i < shelves.size(); i++) {
+        const Shelf& shelf = shelves[i];
+        if (shelf.height < height || shelf.height > height + height / 2 + 2) continue;
+        if (shelf.usedWidth + width + 1 > ATLAS_SIZE) continue;
+        if (best < 0 || shelf.height < shelves[best].height) best = static_cast<int>(i);
+    }
+    if (best >= 0) return best;
+
+    // Open a new shelf below the others
+    if (nextShelfY + height + 1 <= ATLAS_SIZE) {
+        shelves.push_back(Shelf{nextShelfY, height, 1, useStamp});
+        nextShelfY += height + 1;
+        return static_cast<int>(shelves.size() - 1);
+    }
+
+    // The atlas is full, reuse the least recently used shelf
+    return evictShelf(height);
+}
+
+int GlyphCache::evictShelf(int height) {
+    int victim = -1;
+    bool anyHeld = false;
+    for (size_t i = 0; i < shelves.size(); i++) {
+        if (heldFrom != 0 && shelves[i].lastUsed >= heldFrom) {
+            anyHeld = true;
+            continue;
+        }
+        if (shelves[i].height < height) continue;
+        if (victim < 0 || shelves[i].lastUsed < shelves[victim].lastUsed) victim = static_cast<int>(i);
+    }
+
+    // Glyphs still waiting to be drawn are on every shelf that would do
+    if (victim < 0 && anyHeld) return -1;
+
+    if (victim < 0) {
+        // No shelf is tall enough, start the atlas over
+        evictedShelves += shelves.size();
+        for (size_t i = 0; i < glyphCount; i++) {
+            glyphs[i].live = false;
+        }
+        rebuildTable();
+        shelves.clear();
+        nextShelfY = 1;
+        clearRegion(0, ATLAS_SIZE);
+        shelves.push_back(Shelf{nextShelfY, height, 1, useStamp});
+        nextShelfY += height + 1;
+        return 0;
+    }
+
+    emptyShelf(victim);
+    return victim;
+}
+
+bool GlyphCache::freeGlyphSlots() {
+    // Drop the least recently used shelves until a slot is free. Shelves with nothing on
+    // them are skipped, evicting those frees no slots.
+    while (glyphCount == MAX_GLYPHS) {
+        int victim = -1;
+        for (size_t i = 0; i < shelves.size(); i++) {
+            if (heldFrom != 0 && shelves[i].lastUsed >= heldFrom) continue;
+            if (shelves[i].usedWidth <= 1) continue;
+            if (victim < 0 || shelves[i].lastUsed < shelves[victim].lastUsed) victim = static_cast<int>(i);
+        }
+        if (victim < 0) break;
+        emptyShelf(victim);
+    }
+
+    // Glyphs without an outline are on no shelf. Nothing draws from them, so they can
+    // always go and are cheap to add again.
+    if (glyphCount == MAX_GLYPHS) {
+        for (size_t i = 0; i < glyphCount; i++) {
+            if (glyphs[i].shelf < 0) glyphs[i].live = false;
+        }
+        rebuildTable();
+    }
+    return glyphCount < MAX_GLYPHS;
+}
+
+void GlyphCache::emptyShelf(int index) {
+    for (size_t i = 0; i < glyphCount; i++) {
+        if (glyphs[i].shelf == index) glyphs[i].live = false;
+    }
+    rebuildTable();
+    shelves[index].usedWidth = 1;
+    clearRegion(shelves[index].y, shelves[index].height);
+    evictedShelves++;
+}
+
+void GlyphCache::clearRegion(int y, int height) {
+    std::fill(pixels.begin() + static_cast<size_t>(y) * ATLAS_SIZE, pixels.begin() + static_cast<size_t>(y + height) * ATLAS_SIZE, 0);
+    uploadRegion(0, y, ATLAS_SIZE, height);
+}
+
+void GlyphCache::uploadRegion(int x, int y, int width, int height) {
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, ATLAS_SIZE);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RED, GL_UNSIGNED_BYTE,
+                    &pixels[static_cast<size_t>(y) * ATLAS_SIZE + x]);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+}
+
+bool GlyphCache::read(const std::string& path, uint32_t fontHash) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    CacheFileHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION ||
+        header.fontHash != fontHash || header.pixelHeight != pixelHeight || header.atlasSize != ATLAS_SIZE ||
+        header.glyphCount > MAX_GLYPHS || header.shelfCount > shelves.capacity()) {
+        return false;
+    }
+
+    std::vector<Shelf> fileShelves(header.shelfCount);
+    std::vector<Glyph> fileGlyphs(header.glyphCount);
+    std::vector<unsigned char> filePixels(pixels.size());
+    if (!file.read(reinterpret_cast<char*>(fileShelves.data()), fileShelves.size() * sizeof(Shelf)) ||
+        !file.read(reinterpret_cast<char*>(fileGlyphs.data()), fileGlyphs.size() * sizeof(Glyph)) ||
+        !file.read(reinterpret_cast<char*>(filePixels.data()), filePixels.size())) {
+        return false;
+    }
+
+    // Every shelf and glyph must lie inside the atlas, otherwise the file is stale or damaged
+    // and glyphs are rasterised on demand instead
+    if (header.nextShelfY < 1 || header.nextShelfY > ATLAS_SIZE) return false;
+    for (const Shelf& shelf : fileShelves) {
+        if (shelf.y < 1 || shelf.height < 1 || shelf.y + shelf.height > header.nextShelfY) return false;
+        if (shelf.usedWidth < 1 || shelf.usedWidth > ATLAS_SIZE) return false;
+    }
+    for (const Glyph& glyph : fileGlyphs) {
+        glm::ivec2 size = glyph.character.Size;
+        if (glyph.shelf == -1) {
+            if (size != glm::ivec2(0)) return false;
+            continue;
+        }
+        if (glyph.shelf < 0 || static_cast<uint32_t>(glyph.shelf) >= header.shelfCount) return false;
+        const Shelf& shelf = fileShelves[glyph.shelf];
+        if (size.x < 1 || size.y < 1 || size.y > shelf.height || glyph.origin.y != shelf.y) return false;
+        if (glyph.origin.x < 1 || glyph.origin.x + size.x > shelf.usedWidth) return false;
+    }
+
+    // Glyphs from the last run start as the least recently used
+    shelves.assign(fileShelves.begin(), fileShelves.end());
+    for (Shelf& shelf : shelves) {
+        shelf.lastUsed = 0;
+    }
+    std::copy(fileGlyphs.begin(), fileGlyphs.end(), glyphs);
+    glyphCount = fileGlyphs.size();
+    nextShelfY = header.nextShelfY;
+    pixels.swap(filePixels);
+    rebuildTable();
+    uploadRegion(0, 0, ATLAS_SIZE, ATLAS_SIZE);
+    return true;
+}
+
+void GlyphCache::write(const std::string& path, uint32_t fontHash) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return;
+
+    CacheFileHeader header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.fontHash = fontHash;
+    header.pixelHeight = pixelHeight;
+    header.atlasSize = ATLAS_SIZE;
+    header.nextShelfY = nextShelfY;
+    header.shelfCount = static_cast<uint32_t>(shelves.size());
+    header.glyphCount = static_cast<uint32_t>(glyphCount);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(shelves.data()), shelves.size() * sizeof(Shelf));
+    file.write(reinterpret_cast<const char*>(glyphs), glyphCount * sizeof(Glyph));
+    file.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+}
@@ -0,0 +1,103 @@
+// GlyphCache.h
+// Glyphs rasterised on first use into one fixed-size signed distance field atlas. The atlas
+// is packed in shelves (rows of similar height); when it is full the least recently used
+// shelf is evicted and reused, so any text can be drawn while memory stays bounded.
+
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../dependencies/include/stb_truetype.h"
+
+struct Character {
+    glm::ivec2 Size;    // Size of glyph
+    glm::vec2 Bearing;  // Offset from baseline to left/top of glyph
+    float Advance;      // Offset to advance to next glyph
+    glm::vec2 UvMin;    // Glyph rectangle in the atlas
+    glm::vec2 UvMax;
+};
+
+class GlyphCache {
+public:
+    static const int ATLAS_SIZE = 512;   // Width and height of the atlas in texels
+    static const int MAX_GLYPHS = 1024;  // Glyphs cached at once
+
+    ~GlyphCache();
+
+    // Start empty for a font at a pixel height. Creates the atlas texture, so GL thread only.
+    void init(const stbtt_fontinfo* font, float pixelHeight);
+
+    // Call once per string, glyphs used since are the most recently used
+    void beginUse() { useStamp++; }
+    // Cached glyph or nullptr
+    const Character* find(uint32_t codepoint);
+    // Rasterise a glyph into the atlas. May evict shelves, except held ones. Returns
+    // nullptr when the glyph only fits, or a glyph slot only frees up, by evicting a held shelf.
+    const Character* add(uint32_t codepoint);
+    // Hold the shelves of every glyph used from this string on, e.g. while quads queued for
+    // drawing still point at them, until release()
+    void hold() { if (heldFrom == 0) heldFrom = useStamp; }
+    void release() { heldFrom = 0; }
+    // Advance of a glyph, without rasterising it when it is not cached
+    float advance(uint32_t codepoint);
+
+    GLuint texture() const { return atlasTexture; }
+    // Delete the atlas texture while the GL context is still current. The glyphs stay in
+    // memory, so the disk cache can still be written.
+    void deleteTexture();
+    size_t size() const { return glyphCount; }
+    size_t evictions() const { return evictedShelves; }
+
+    // Keep the resident glyphs across launches. The cache is only used with the same font
+    // file (by hash) and size.
+    bool read(const std::string& path, uint32_t fontHash);
+    void write(const std::string& path, uint32_t fontHash) const;
+
+private:
+    struct Shelf {
+        int y;
+        int height;
+        int usedWidth;
+        uint32_t lastUsed;  // useStamp of the last string that used a glyph on it
+    };
+    struct Glyph {
+        Character character;
+        uint32_t codepoint;
+        int shelf;  // -1 when the glyph takes no atlas space, e.g. space
+        glm::ivec2 origin;
+        bool live;
+    };
+
+    const stbtt_fontinfo* font = nullptr;
+    float pixelHeight = 0.0f;
+    float scale = 0.0f;
+    GLuint atlasTexture = 0;
+    std::vector<unsigned char> pixels;  // Copy of the atlas, for eviction and the disk cache
+
+    std::vector<Shelf> shelves;
+    int nextShelfY = 0;
+    Glyph glyphs[MAX_GLYPHS];
+    size_t glyphCount = 0;
+    // Open addressing table from codepoint to glyph index, -1 for empty
+    static const int TABLE_SIZE = MAX_GLYPHS * 2;
+    int16_t table[TABLE_SIZE];
+    uint32_t useStamp = 1;
+    uint32_t heldFrom = 0;  // First useStamp of the hold, 0 when nothing is held
+    size_t evictedShelves = 0;
+
+    int findSlot(uint32_t codepoint) const;
+    void rebuildTable();
+    int placeShelf(int width, int height);
+    int evictShelf(int height);
+    // Evict until a glyph slot is free, false when only held glyphs are left
+    bool freeGlyphSlots();
+    void emptyShelf(int index);
+    void clearRegion(int y, int height);
+    void uploadRegion(int x, int y, int width, int height);
+};
+
+#endif // GLYPH_CACHE_H
@@ -0,0 +1,113 @@
+#include "GpuProfiler.h"
+#include <glad/glad.h>
+#include <algorithm>
+
+// Frames whose queries can be in flight at once. A frame is read back when its slot comes
+// round again, or earlier if the GPU is done with it.
+static const int GPU_FRAMES = 4;
+static const int MAX_GPU_ZONES = 32;  // Per frame
+
+struct GpuFrame {
+    GLuint queries[MAX_GPU_ZONES * 2];  // Start and end timestamp of every zone
+    const char* names[MAX_GPU_ZONES];
+    int zoneCount = 0;
+    bool pending = false;      // Queries issued and not read back yet
+    int64_t clockOffset = 0;   // Profiler time minus GPU time, taken when the frame ended
+};
+
+static GpuFrame frames[GPU_FRAMES];
+static int currentFrame = 0;
+static bool initialised = false;
+static int gpuTrack = -1;
+static double lastFrameMilliseconds = 0.0;
+
+void gpuProfileInit() {
+    for (GpuFrame& frame : frames) {
+        glGenQueries(MAX_GPU_ZONES * 2, frame.queries);
+    }
+    initialised = true;
+}
+
+void gpuProfileShutdown() {
+    if (!initialised) return;
+    for (GpuFrame& frame : frames) {
+        glDeleteQueries(MAX_GPU_ZONES * 2, frame.queries);
+    }
+    initialised = false;
+}
+
+int gpuProfileBegin(const char* name) {
+    if (!initialised) return -1;
+    GpuFrame& frame = frames[currentFrame];
+    if (frame.zoneCount == MAX_GPU_ZONES) return -1;
+
+    int zone = frame.zoneCount++;
+    frame.names[zone] = name;
+    glQueryCounter(frame.queries[zone * 2], GL_TIMESTAMP);
+    return zone;
+}
+
+void gpuProfileEnd(int zone) {
+    if (zone < 0) return;
+    glQueryCounter(frames[currentFrame].queries[zone * 2 + 1], GL_TIMESTAMP);
+}
+
+// Read a frame's results if the GPU has written all of them, without waiting
+static bool readFrame(GpuFrame& frame) {
+    for (int q = 0; q < frame.zoneCount * 2; q++) {
+        GLint available = 0;
+        glGetQueryObjectiv(frame.queries[q], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return false;
+    }
+
+    bool capturing = profileCapturing();
+    if (capturing && gpuTrack < 0) gpuTrack = profileTrack("GPU");
+
+    GLuint64 first = ~GLuint64(0), last = 0;
+    for (int zone = 0; zone < frame.zoneCount; zone++) {
+        GLuint64 begin = 0, end = 0;
+        glGetQueryObjectui64v(frame.queries[zone * 2], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(frame.queries[zone * 2 + 1], GL_QUERY_RESULT, &end);
+        first = std::min(first, begin);
+        last = std::max(last, end);
+
+        // Moved onto the CPU zones' clock, so both line up in the trace
+        int64_t cpuBegin = static_cast<int64_t>(begin) + frame.clockOffset;
+        int64_t cpuEnd = static_cast<int64_t>(end) + frame.clockOffset;
+        if (capturing && cpuBegin > 0 && cpuEnd >= cpuBegin) {
+            profileRecordOnTrack(gpuTrack, frame.names[zone], static_cast<uint64_t>(cpuBegin), static_cast<uint64_t>(cpuEnd));
+        }
+    }
+    if (frame.zoneCount > 0) lastFrameMilliseconds = (last - first) / 1.0e6;
+
+    frame.pending = false;
+    frame.zoneCount = 0;
+    return true;
+}
+
+void gpuProfileEndFrame() {
+    if (!initialised) return;
+
+    GpuFrame& frame = frames[currentFrame];
+    if (frame.zoneCount > 0) {
+        GLint64 gpuNow = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+        frame.clockOffset = static_cast<int64_t>(profileNow()) - gpuNow;
+        frame.pending = true;
+    }
+    currentFrame = (currentFrame + 1) % GPU_FRAMES;
+
+    // Oldest first; the GPU finishes frames in order, so stop at the first one still running
+    for (int i = 0; i < GPU_FRAMES; i++) {
+        GpuFrame& older = frames[(currentFrame + i) % GPU_FRAMES];
+        if (older.pending && !readFrame(older)) break;
+    }
+
+    // Still not done after GPU_FRAMES frames, its queries are reused and the results dropped
+    frames[currentFrame].pending = false;
+    frames[currentFrame].zoneCount = 0;
+}
+
+double gpuProfileFrameMilliseconds() {
+    return lastFrameMilliseconds;
+}
@@ -0,0 +1,48 @@
+// GpuProfiler.h
+// GPU time of render passes. GPU_PROFILE_ZONE("name") brackets the GL commands of the rest
+// of the scope with two timestamp queries. The queries of a frame are read back a few
+// frames later, once the GPU has finished them, so timing never stalls the pipeline. While
+// a profiler capture runs the results are recorded on a "GPU" track of the same trace,
+// lined up with the CPU zones.
+//
+// GL thread only. Compiled out with the CPU zones by -DPROFILE_ENABLED=0.
+
+#ifndef GPU_PROFILER_H
+#define GPU_PROFILER_H
+
+#include "Profiler.h"
+
+// Create the queries. Zones before this are ignored.
+void gpuProfileInit();
+void gpuProfileShutdown();
+
+// Start a zone, returns its index in the frame or -1 when the frame is out of queries
+int gpuProfileBegin(const char* name);
+void gpuProfileEnd(int zone);
+
+// Once per frame after its last zone: move to the next frame's queries and read back the
+// frames the GPU has finished
+void gpuProfileEndFrame();
+
+// GPU time from the first zone's start to the last zone's end, in the newest frame read
+// back, in milliseconds
+double gpuProfileFrameMilliseconds();
+
+class GpuProfileZone {
+public:
+    explicit GpuProfileZone(const char* name) : zone(gpuProfileBegin(name)) {}
+    ~GpuProfileZone() { gpuProfileEnd(zone); }
+    GpuProfileZone(const GpuProfileZone&) = delete;
+    GpuProfileZone& operator=(const GpuProfileZone&) = delete;
+
+private:
+    int zone;
+};
+
+#if PROFILE_ENABLED
+#define GPU_PROFILE_ZONE(name) GpuProfileZone PROFILE_CONCAT(gpuProfileZone, __LINE__)(name)
+#else
+#define GPU_PROFILE_ZONE(name) ((void)0)
+#endif
+
+#endif // GPU_PROFILER_H
@@ -0,0 +1,181 @@
+#include "Log.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Every thread that logs gets one ring from a fixed pool, so logging never allocates
+static const uint32_t MAX_LOG_THREADS = 64;
+static const uint32_t RING_SIZE = 128;  // Power of two
+
+// Single producer (the owning thread), single consumer (the writer)
+struct LogRing {
+    std::atomic<uint32_t> head{0};      // Next record the thread writes
+    std::atomic<uint32_t> tail{0};      // Next record the writer reads
+    std::atomic<uint64_t> dropped{0};   // Messages lost to a full ring
+    LogRecord records[RING_SIZE];
+};
+
+static LogRing rings[MAX_LOG_THREADS];
+static std::atomic<uint32_t> ringCount{0};
+static std::atomic<uint64_t> nextSequence{0};
+static std::atomic<uint64_t> droppedWithoutRing{0};
+static thread_local LogRing* threadRing = nullptr;
+static thread_local bool threadHasNoRing = false;
+
+static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+// How often the writer looks for new messages
+static const std::chrono::milliseconds WRITE_INTERVAL(5);
+
+static std::once_flag startFlag;
+static std::mutex writerMutex;
+static std::condition_variable writerWake;
+static bool stopWriter = false;
+static std::thread writerThread;
+
+static const char* levelName(int level) {
+    switch (level) {
+    case LOG_LEVEL_DEBUG: return "DEBUG";
+    case LOG_LEVEL_INFO: return "INFO";
+    case LOG_LEVEL_WARN: return "WARN";
+    default: return "ERROR";
+    }
+}
+
+// Replace every "{}" of the format with the next argument
+static void formatRecord(const LogRecord& record, std::string& out) {
+    char number[64];
+    std::snprintf(number, sizeof(number), "[%s %.3f] ", levelName(record.level), record.time);
+    out += number;
+
+    int next = 0;
+    for (const char* c = record.format; *c; c++) {
+        if (c[0] != '{' || c[1] != '}' || next >= record.argCount) {
+            out += *c;
+            continue;
+        }
+        const LogArg& arg = record.args[next++];
+        switch (arg.type) {
+        case LogArg::INT: std::snprintf(number, sizeof(number), "%lld", static_cast<long long>(arg.i)); break;
+        case LogArg::UINT: std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(arg.u)); break;
+        case LogArg::FLOAT: std::snprintf(number, sizeof(number), "%g", arg.f); break;
+        case LogArg::BOOL: std::snprintf(number, sizeof(number), "%s", arg.b ? "true" : "false"); break;
+        case LogArg::TEXT: number[0] = '\0'; out += record.text + arg.textOffset; break;
+        }
+        out += number;
+        c++;  // Skip the '}'
+    }
+    out += '\n';
+}
+
+// Take every waiting record out of the rings and print them in the order they were logged
+static void drainRings(std::vector<LogRecord>& batch, std::string& text) {
+    batch.clear();
+    uint64_t dropped = droppedWithoutRing.exchange(0);
+
+    uint32_t count = std::min(ringCount.load(std::memory_order_acquire), MAX_LOG_THREADS);
+    for (uint32_t r = 0; r < count; r++) {
+        LogRing& ring = rings[r];
+        uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+        uint32_t head = ring.head.load(std::memory_order_acquire);
+        for (; tail != head; tail++) {
+            batch.push_back(ring.records[tail & (RING_SIZE - 1)]);
+        }
+        ring.tail.store(tail, std::memory_order_release);
+        dropped += ring.dropped.exchange(0);
+    }
+    if (batch.empty() && dropped == 0) return;
+
+    std::sort(batch.begin(), batch.end(), [](const LogRecord& a, const LogRecord& b) { return a.sequence < b.sequence; });
+    text.clear();
+    for (const LogRecord& record : batch) {
+        formatRecord(record, text);
+    }
+    if (dropped > 0) {
+        char line[96];
+        std::snprintf(line, sizeof(line), "[WARN] %llu log messages dropped, a ring was full\n", static_cast<unsigned long long>(dropped));
+        text += line;
+    }
+    std::fwrite(text.data(), 1, text.size(), stdout);
+    std::fflush(stdout);
+}
+
+static void writerLoop() {
+    std::vector<LogRecord> batch;
+    batch.reserve(MAX_LOG_THREADS * RING_SIZE / 4);
+    std::string text;
+
+    std::unique_lock<std::mutex> lock(writerMutex);
+    while (!stopWriter) {
+        writerWake.wait_for(lock, WRITE_INTERVAL);
+        lock.unlock();
+        drainRings(batch, text);
+        lock.lock();
+    }
+    lock.unlock();
+    drainRings(batch, text);
+}
+
+void logStart() {
+    std::call_once(startFlag, []() { writerThread = std::thread(writerLoop); });
+}
+
+void logShutdown() {
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        if (stopWriter) return;
+        stopWriter = true;
+    }
+    writerWake.notify_all();
+    if (writerThread.joinable()) writerThread.join();
+}
+
+// Shut the writer down on exit if main did not
+static struct LogShutdownAtExit {
+    ~LogShutdownAtExit() { logShutdown(); }
+} logShutdownAtExit;
+
+LogRecord* logBegin(int level, const char* format) {
+    logStart();
+
+    if (!threadRing) {
+        if (threadHasNoRing) {
+            droppedWithoutRing.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        uint32_t index = ringCount.fetch_add(1, std::memory_order_acq_rel);
+        if (index >= MAX_LOG_THREADS) {
+            threadHasNoRing = true;
+            droppedWithoutRing.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        threadRing = &rings[index];
+    }
+
+    LogRing& ring = *threadRing;
+    uint32_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) == RING_SIZE) {
+        ring.dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    LogRecord& record = ring.records[head & (RING_SIZE - 1)];
+    record.sequence = nextSequence.fetch_add(1, std::memory_order_relaxed);
+    record.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    record.format = format;
+    record.level = static_cast<uint8_t>(level);
+    record.argCount = 0;
+    record.textUsed = 0;
+    return &record;
+}
+
+void logCommit(LogRecord*) {
+    // Only the owning thread moves head, publishing the record to the writer
+    LogRing& ring = *threadRing;
+    ring.head.store(ring.head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
@@ -0,0 +1,140 @@
+// Log.h
+// Logging for hot paths. A log call copies its format string and arguments into a ring
+// buffer owned by the calling thread, with no lock and no allocation, and a background
+// writer thread formats and prints the messages. "{}" in the format is replaced by the
+// next argument, e.g. LOG_INFO("Cow hit at {}, {}", x, z).
+//
+// Levels below LOG_MIN_LEVEL compile to nothing, set it with e.g. -DLOG_MIN_LEVEL=0 to
+// keep debug messages. A full ring drops messages instead of stalling the game; the
+// writer reports how many were lost.
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO  1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_ERROR 3
+#define LOG_LEVEL_OFF   4
+
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_LEVEL_INFO
+#endif
+
+// Values of one log argument, captured by value
+struct LogArg {
+    enum Type : uint8_t { INT, UINT, FLOAT, TEXT, BOOL };
+    Type type;
+    union {
+        int64_t i;
+        uint64_t u;
+        double f;
+        uint16_t textOffset;  // Into LogRecord::text
+        bool b;
+    };
+};
+
+// One message waiting for the writer. The format must be a string literal, it is not copied.
+struct LogRecord {
+    static const int MAX_ARGS = 8;
+    static const int TEXT_SIZE = 96;
+
+    uint64_t sequence;       // Orders messages across threads
+    double time;             // Seconds since the logger started
+    const char* format;
+    uint8_t level;
+    uint8_t argCount;
+    uint16_t textUsed;
+    LogArg args[MAX_ARGS];
+    char text[TEXT_SIZE];    // Copies of string arguments
+};
+
+// Start the writer thread. Logging starts it on first use otherwise, but that first call
+// then allocates, so call this during startup.
+void logStart();
+// Print everything logged so far and stop the writer, e.g. before exiting
+void logShutdown();
+
+// Claim a record in the calling thread's ring, nullptr when the ring is full
+LogRecord* logBegin(int level, const char* format);
+// Hand a filled record to the writer
+void logCommit(LogRecord* record);
+
+// Text arguments
+inline const char* logText(const char* value) { return value; }
+inline const char* logText(const std::string& value) { return value.c_str(); }
+
+// Store one argument in a record
+template <typename T>
+inline void logArg(LogRecord& record, const T& value) {
+    if (record.argCount == LogRecord::MAX_ARGS) return;
+    LogArg& arg = record.args[record.argCount++];
+    if constexpr (std::is_same<T, bool>::value) {
+        arg.type = LogArg::BOOL;
+        arg.b = value;
+    } else if constexpr (std::is_floating_point<T>::value) {
+        arg.type = LogArg::FLOAT;
+        arg.f = value;
+    } else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+        arg.type = LogArg::INT;
+        arg.i = value;
+    } else if constexpr (std::is_integral<T>::value || std::is_enum<T>::value) {
+        arg.type = LogArg::UINT;
+        arg.u = static_cast<uint64_t>(value);
+    } else {
+        // Anything else must be text, it is copied because it may not outlive the call
+        arg.type = LogArg::TEXT;
+        size_t room = LogRecord::TEXT_SIZE - record.textUsed;
+        if (room == 0) {
+            // The text space is used up, the last byte is a terminator so this prints as empty
+            arg.textOffset = LogRecord::TEXT_SIZE - 1;
+            return;
+        }
+        const char* string = logText(value);
+        size_t length = std::strlen(string);
+        if (length >= room) length = room - 1;
+        arg.textOffset = record.textUsed;
+        std::memcpy(record.text + record.textUsed, string, length);
+        record.text[record.textUsed + length] = '\0';
+        record.textUsed = static_cast<uint16_t>(record.textUsed + length + 1);
+    }
+}
+
+template <typename... Args>
+inline void logWrite(int level, const char* format, const Args&... args) {
+    LogRecord* record = logBegin(level, format);
+    if (!record) return;
+    (logArg(*record, args), ...);
+    logCommit(record);
+}
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) logWrite(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(...) logWrite(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_WARN
+#define LOG_WARN(...) logWrite(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) logWrite(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
+
+#endif // LOG_H
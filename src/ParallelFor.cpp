@@ -0,0 +1,92 @@
+#include "ParallelFor.h"
+#include "AllocationTracker.h"
+#include "Profiler.h"
+#include <chrono>
+
+WorkerPool& WorkerPool::instance() {
+    static WorkerPool pool;
+    return pool;
+}
+
+WorkerPool::WorkerPool() {
+    size_t threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    workers.reserve(threads - 1);
+    for (size_t i = 1; i < threads; i++) {
+        workers.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkerPool::run(size_t count, void (*runTask)(void*, size_t), void* runContext) {
+    std::lock_guard<std::mutex> runLock(runMutex);
+    {
+        // A worker that woke up late for the last run may still be looking at its counters
+        std::unique_lock<std::mutex> lock(mutex);
+        jobDone.wait(lock, [this]() { return busyWorkers == 0; });
+
+        task = runTask;
+        context = runContext;
+        chunkCount = count;
+        forbidAllocations = allocationsForbidden();
+        nextChunk.store(0);
+        finishedChunks.store(0);
+        generation++;
+    }
+    wakeWorkers.notify_all();
+
+    // The calling thread takes chunks as well
+    runChunks(runTask, runContext, count);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    jobDone.wait(lock, [this, count]() { return finishedChunks.load() == count; });
+}
+
+void WorkerPool::runChunks(void (*runTask)(void*, size_t), void* runContext, size_t count) {
+    for (size_t chunk = nextChunk.fetch_add(1); chunk < count; chunk = nextChunk.fetch_add(1)) {
+        runTask(runContext, chunk);
+        if (finishedChunks.fetch_add(1) + 1 == count) {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobDone.notify_all();
+        }
+    }
+}
+
+void WorkerPool::workerLoop() {
+    PROFILE_THREAD("worker");
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wakeWorkers.wait(lock, [this, &seen]() { return stopping || generation != seen; });
+        if (stopping) return;
+        seen = generation;
+
+        void (*runTask)(void*, size_t) = task;
+        void* runContext = context;
+        size_t count = chunkCount;
+        bool forbid = forbidAllocations;
+        busyWorkers++;
+        lock.unlock();
+
+        {
+            NoAllocationScope scope(forbid);
+            auto start = std::chrono::steady_clock::now();
+            runChunks(runTask, runContext, count);
+            auto busy = std::chrono::steady_clock::now() - start;
+            busyTime.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(busy).count(), std::memory_order_relaxed);
+        }
+
+        lock.lock();
+        busyWorkers--;
+        jobDone.notify_all();
+    }
+}
@@ -0,0 +1,84 @@
+// ParallelFor.h
+// Splits an index range into contiguous chunks and runs them on worker threads.
+
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Worker threads started once and shared by every parallelFor, so splitting a loop
+// allocates nothing and starts no threads once the game is running
+class WorkerPool {
+public:
+    static WorkerPool& instance();
+    ~WorkerPool();
+
+    // Threads that work on a run, the calling thread included
+    size_t threadCount() const { return workers.size() + 1; }
+    size_t workerCount() const { return workers.size(); }
+    // Nanoseconds the workers have spent running chunks, summed over all of them
+    uint64_t busyNanoseconds() const { return busyTime.load(std::memory_order_relaxed); }
+
+    // Call task(context, chunk) for every chunk in [0, chunkCount) and wait for all of them.
+    // Runs are serialised, and a task must not start another run.
+    void run(size_t chunkCount, void (*task)(void*, size_t), void* context);
+
+private:
+    WorkerPool();
+    void workerLoop();
+    void runChunks(void (*task)(void*, size_t), void* context, size_t chunkCount);
+
+    std::vector<std::thread> workers;
+    std::mutex runMutex;                  // Held for a whole run
+    std::mutex mutex;                     // Guards the job below
+    std::condition_variable wakeWorkers;
+    std::condition_variable jobDone;
+    uint64_t generation = 0;              // Bumped for every run
+    bool stopping = false;
+    size_t busyWorkers = 0;               // Workers still inside a run
+
+    // The current run
+    void (*task)(void*, size_t) = nullptr;
+    void* context = nullptr;
+    size_t chunkCount = 0;
+    bool forbidAllocations = false;       // Workers take over the caller's NoAllocationScope
+    std::atomic<size_t> nextChunk{0};
+    std::atomic<size_t> finishedChunks{0};
+    std::atomic<uint64_t> busyTime{0};
+};
+
+// Calls fn(begin, end) over [0, count). Ranges smaller than minChunk run inline on the
+// calling thread, larger ones are spread over the threads of the WorkerPool.
+template <typename Fn>
+void parallelFor(size_t count, size_t minChunk, Fn&& fn) {
+    WorkerPool& pool = WorkerPool::instance();
+    size_t chunks = std::min(pool.threadCount(), (count + minChunk - 1) / std::max<size_t>(1, minChunk));
+    if (chunks <= 1) {
+        fn(size_t(0), count);
+        return;
+    }
+
+    struct Job {
+        std::remove_reference_t<Fn>* fn;
+        size_t count;
+        size_t chunkSize;
+    };
+    Job job{&fn, count, (count + chunks - 1) / chunks};
+    chunks = (count + job.chunkSize - 1) / job.chunkSize;
+
+    pool.run(chunks, [](void* context, size_t chunk) {
+        const Job& job = *static_cast<const Job*>(context);
+        size_t begin = chunk * job.chunkSize;
+        (*job.fn)(begin, std::min(job.count, begin + job.chunkSize));
+    }, &job);
+}
+
+#endif // PARALLEL_FOR_H
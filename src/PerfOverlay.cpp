@@ -0,0 +1,107 @@
+#include "PerfOverlay.h"
+#include <algorithm>
+#include <chrono>
+#include "ParallelFor.h"
+
+static const double REFRESH_SECONDS = 0.25;
+
+// Layout, in the 1024x768 screen projection of the HUD
+static const float PANEL_X = 20.0f;
+static const float PANEL_TOP = 700.0f;
+static const float PANEL_WIDTH = 380.0f;
+static const float PADDING = 10.0f;
+static const float LINE_HEIGHT = 18.0f;
+static const float TEXT_SCALE = 0.5f;
+static const int TEXT_LINES = 7;
+
+// The graph is one bar per frame, 60 fps is the lower reference line
+static const float GRAPH_HEIGHT = 60.0f;
+static const float GRAPH_MAX_MS = 50.0f;
+static const float TARGET_MS = 1000.0f / 60.0f;
+
+void PerfOverlay::addFrame(double frameSeconds) {
+    frameTimes[nextFrame] = static_cast<float>(frameSeconds * 1000.0);
+    nextFrame = (nextFrame + 1) % FRAME_WINDOW;
+    frameCount = std::min(frameCount + 1, FRAME_WINDOW);
+
+    sinceRefresh += frameSeconds;
+    if (sinceRefresh >= REFRESH_SECONDS) refresh();
+}
+
+void PerfOverlay::refresh() {
+    float sorted[FRAME_WINDOW];
+    std::copy(frameTimes, frameTimes + frameCount, sorted);
+    std::sort(sorted, sorted + frameCount);
+    auto percentile = [&](float fraction) {
+        return sorted[std::min(frameCount - 1, static_cast<int>(fraction * frameCount))];
+    };
+    p50Ms = percentile(0.50f);
+    p95Ms = percentile(0.95f);
+    p99Ms = percentile(0.99f);
+
+    float total = 0.0f;
+    for (int i = 0; i < frameCount; i++) {
+        total += sorted[i];
+    }
+    averageMs = total / frameCount;
+
+    // Share of the workers' time since the last refresh spent running chunks
+    WorkerPool& pool = WorkerPool::instance();
+    uint64_t busy = pool.busyNanoseconds();
+    if (pool.workerCount() > 0) {
+        workerUtilisation = static_cast<float>((busy - lastBusyNanoseconds) / (sinceRefresh * 1.0e9 * pool.workerCount()));
+    }
+    lastBusyNanoseconds = busy;
+    sinceRefresh = 0.0;
+}
+
+void PerfOverlay::draw(SpriteBatch& batch, TextRenderer& font, FrameArena& arena, const glm::mat4& projection,
+                       const PerfCounters& counters) {
+    if (!visible) return;
+    auto start = std::chrono::steady_clock::now();
+
+    batch.begin(projection);
+    float panelHeight = TEXT_LINES * LINE_HEIGHT + GRAPH_HEIGHT + 3.0f * PADDING;
+    float panelBottom = PANEL_TOP - panelHeight;
+    batch.solid(PANEL_X, panelBottom, PANEL_WIDTH, panelHeight, glm::vec4(0.0f, 0.0f, 0.0f, 0.6f), LAYER_BACKGROUND);
+
+    // Frame time graph, oldest frame on the left
+    float graphX = PANEL_X + PADDING;
+    float graphY = panelBottom + PADDING;
+    float graphWidth = PANEL_WIDTH - 2.0f * PADDING;
+    float barWidth = graphWidth / FRAME_WINDOW;
+    for (int i = 0; i < frameCount; i++) {
+        float ms = frameTimes[(nextFrame - frameCount + i + FRAME_WINDOW) % FRAME_WINDOW];
+        glm::vec4 color = ms <= TARGET_MS ? glm::vec4(0.3f, 0.9f, 0.3f, 1.0f)
+                        : ms <= 2.0f * TARGET_MS ? glm::vec4(0.95f, 0.8f, 0.2f, 1.0f)
+                        : glm::vec4(0.95f, 0.25f, 0.2f, 1.0f);
+        float height = std::min(ms, GRAPH_MAX_MS) / GRAPH_MAX_MS * GRAPH_HEIGHT;
+        batch.solid(graphX + (FRAME_WINDOW - frameCount + i) * barWidth, graphY, barWidth, height, color);
+    }
+    for (float reference : {TARGET_MS, 2.0f * TARGET_MS}) {
+        batch.solid(graphX, graphY + reference / GRAPH_MAX_MS * GRAPH_HEIGHT, graphWidth, 1.0f,
+                    glm::vec4(1.0f, 1.0f, 1.0f, 0.5f));
+    }
+
+    // Text, top line first
+    const RenderStats& render = counters.render;
+    const char* lines[TEXT_LINES] = {
+        arena.format("FPS %.0f   frame %.2f ms   GPU %.2f ms", averageMs > 0.0f ? 1000.0f / averageMs : 0.0f,
+                     averageMs, counters.gpuMilliseconds),
+        arena.format("p50 %.2f   p95 %.2f   p99 %.2f ms", p50Ms, p95Ms, p99Ms),
+        arena.format("draws %u   triangles %.1fk", render.drawCalls, render.triangles / 1000.0),
+        arena.format("binds: programs %u   textures %u", render.programBinds, render.textureBinds),
+        arena.format("particles %zu   agents %zu of %zu active", counters.particles, counters.activeAgents,
+                     counters.agents),
+        arena.format("workers %zu   %.0f%% busy", WorkerPool::instance().workerCount(), workerUtilisation * 100.0f),
+        arena.format("overlay %.3f ms", overlayMilliseconds),
+    };
+    float lineY = PANEL_TOP - PADDING - LINE_HEIGHT * 0.8f;
+    for (int i = 0; i < TEXT_LINES; i++) {
+        glm::vec3 color = i == TEXT_LINES - 1 ? glm::vec3(0.6f) : glm::vec3(1.0f);
+        batch.text(font, lines[i], PANEL_X + PADDING, lineY - i * LINE_HEIGHT, TEXT_SCALE, color);
+    }
+    batch.end();
+
+    overlayMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,61 @@
+// PerfOverlay.h
+// Frame statistics drawn over the game, toggled with F3: frame rate, frame time
+// percentiles and a graph over the last FRAME_WINDOW frames, the GL work of the last frame,
+// particles, agents and how busy the worker threads are. Percentiles and utilisation are
+// refreshed a few times a second so the numbers can be read. Nothing here allocates, and
+// the overlay's own CPU time is shown on its last line.
+
+#ifndef PERF_OVERLAY_H
+#define PERF_OVERLAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "FrameArena.h"
+#include "RenderStats.h"
+#include "SpriteBatch.h"
+#include "TextRenderer.h"
+
+// What the rest of the game reports for one frame
+struct PerfCounters {
+    RenderStats render;       // Of the last finished frame
+    size_t particles = 0;
+    size_t activeAgents = 0;
+    size_t agents = 0;
+    double gpuMilliseconds = 0.0;
+};
+
+class PerfOverlay {
+public:
+    static const int FRAME_WINDOW = 240;  // Frames in the percentiles and the graph
+
+    void toggle() { visible = !visible; }
+    bool isVisible() const { return visible; }
+
+    // Record the length of the frame that just finished
+    void addFrame(double frameSeconds);
+
+    // Draw the overlay as its own batch, after the rest of the HUD
+    void draw(SpriteBatch& batch, TextRenderer& font, FrameArena& arena, const glm::mat4& projection,
+              const PerfCounters& counters);
+
+private:
+    bool visible = false;
+
+    float frameTimes[FRAME_WINDOW] = {};  // Milliseconds, a ring
+    int frameCount = 0;
+    int nextFrame = 0;
+
+    // Refreshed every REFRESH_SECONDS
+    double sinceRefresh = 0.0;
+    float averageMs = 0.0f;
+    float p50Ms = 0.0f, p95Ms = 0.0f, p99Ms = 0.0f;
+    float workerUtilisation = 0.0f;
+    uint64_t lastBusyNanoseconds = 0;
+
+    double overlayMilliseconds = 0.0;  // CPU time of the last draw()
+
+    void refresh();
+};
+
+#endif // PERF_OVERLAY_H
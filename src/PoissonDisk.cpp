@@ -0,0 +1,100 @@
+#include "PoissonDisk.h"
+#include <cmath>
+#include <cstdint>
+
+// Candidates tried around each active sample before it is retired
+static const int ATTEMPTS_PER_SAMPLE = 30;
+// Area kept clear around the car start, half sizes on X and Z
+static const float CLEAR_HALF_X = 5.0f;
+static const float CLEAR_HALF_Z = 3.0f;
+
+static bool insideClearArea(const glm::vec2& point) {
+    return std::fabs(point.x) < CLEAR_HALF_X && std::fabs(point.y) < CLEAR_HALF_Z;
+}
+
+std::vector<glm::vec3> samplePoissonDisk(int count, float range, float minDistance, RandomStream& random) {
+    std::vector<glm::vec3> positions;
+    if (count <= 0 || range <= 0.0f) return positions;
+
+    // Cells small enough that each holds at most one sample
+    float cellSize = minDistance / std::sqrt(2.0f);
+    int gridSize = std::max(1, static_cast<int>(std::ceil(2.0f * range / cellSize)));
+    std::vector<int32_t> grid(static_cast<size_t>(gridSize) * gridSize, -1);
+    std::vector<glm::vec2> samples;
+    std::vector<uint32_t> active;
+
+    auto cellOf = [&](const glm::vec2& point, int& cx, int& cz) {
+        cx = std::min(gridSize - 1, static_cast<int>((point.x + range) / cellSize));
+        cz = std::min(gridSize - 1, static_cast<int>((point.y + range) / cellSize));
+    };
+
+    // A candidate is valid if it is inside the area and no sample in the nearby cells is too close
+    auto isValid = [&](const glm::vec2& point) {
+        if (point.x < -range || point.x > range || point.y < -range || point.y > range) return false;
+        if (insideClearArea(point)) return false;
+
+        int cx, cz;
+        cellOf(point, cx, cz);
+        for (int z = std::max(0, cz - 2); z <= std::min(gridSize - 1, cz + 2); z++) {
+            for (int x = std::max(0, cx - 2); x <= std::min(gridSize - 1, cx + 2); x++) {
+                int32_t other = grid[static_cast<size_t>(z) * gridSize + x];
+                if (other >= 0) {
+                    glm::vec2 offset = samples[other] - point;
+                    if (glm::dot(offset, offset) < minDistance * minDistance) return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    auto addSample = [&](const glm::vec2& point) {
+        int cx, cz;
+        cellOf(point, cx, cz);
+        grid[static_cast<size_t>(cz) * gridSize + cx] = static_cast<int32_t>(samples.size());
+        active.push_back(static_cast<uint32_t>(samples.size()));
+        samples.push_back(point);
+    };
+
+    // Throw darts over the whole area first, so sparse layouts spread evenly.
+    // Give up after a run of misses, the area is then too crowded for darts to work well.
+    int misses = 0;
+    while (samples.size() < static_cast<size_t>(count) && misses < ATTEMPTS_PER_SAMPLE) {
+        glm::vec2 point(random.range(-range, range), random.range(-range, range));
+        if (isValid(point)) {
+            addSample(point);
+            misses = 0;
+        } else {
+            misses++;
+        }
+    }
+
+    // Fill the gaps by growing around random active samples (Bridson). Every sample is active
+    // once and gets ATTEMPTS_PER_SAMPLE tries, so the work is bounded by the number of samples.
+    while (samples.size() < static_cast<size_t>(count) && !active.empty()) {
+        uint32_t pick = static_cast<uint32_t>(random.nextFloat() * active.size());
+        glm::vec2 centre = samples[active[pick]];
+
+        bool placed = false;
+        for (int attempt = 0; attempt < ATTEMPTS_PER_SAMPLE; attempt++) {
+            // Random point in the ring between minDistance and 2 * minDistance
+            float angle = random.range(0.0f, 6.2831853f);
+            float radius = minDistance * std::sqrt(random.range(1.0f, 4.0f));
+            glm::vec2 candidate = centre + glm::vec2(std::cos(angle), std::sin(angle)) * radius;
+            if (isValid(candidate)) {
+                addSample(candidate);
+                placed = true;
+                break;
+            }
+        }
+        if (!placed) {
+            active[pick] = active.back();
+            active.pop_back();
+        }
+    }
+
+    positions.reserve(samples.size());
+    for (const glm::vec2& sample : samples) {
+        positions.push_back(glm::vec3(sample.x, 0.0f, sample.y));
+    }
+    return positions;
+}
@@ -0,0 +1,18 @@
+// PoissonDisk.h
+// Spawn positions on the ground plane that keep a minimum distance between each other.
+
+#ifndef POISSON_DISK_H
+#define POISSON_DISK_H
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "Random.h"
+
+// Pick up to 'count' points in [-range, range] on X and Z, at least minDistance apart and
+// outside the clear area around the car start. Distance checks use a background grid, so
+// each candidate costs the same whatever the count. Random darts spread the points first,
+// then Poisson-disk growth (Bridson) fills the gaps with a fixed number of attempts per point.
+// Returns fewer points if the area cannot hold 'count' of them.
+std::vector<glm::vec3> samplePoissonDisk(int count, float range, float minDistance, RandomStream& random);
+
+#endif // POISSON_DISK_H
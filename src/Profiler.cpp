@@ -0,0 +1,148 @@
+#include "Profiler.h"
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// Every thread that records, and every extra track, gets one buffer from a fixed pool,
+// so recording never allocates
+static const uint32_t MAX_PROFILE_THREADS = 64;
+static const size_t EVENTS_PER_THREAD = 1 << 14;
+
+struct ProfileEvent {
+    const char* name;
+    uint64_t begin;
+    uint64_t end;
+};
+
+// Written only by the owning thread, read when the capture is written out
+struct ProfileBuffer {
+    std::atomic<size_t> count{0};
+    ProfileEvent* events = nullptr;
+    std::atomic<const char*> threadName{nullptr};
+};
+
+static ProfileBuffer buffers[MAX_PROFILE_THREADS];
+static std::vector<ProfileEvent> eventStorage;
+static std::atomic<uint32_t> bufferCount{0};
+static std::atomic<uint64_t> droppedEvents{0};
+static std::atomic<bool> capturing{false};
+static thread_local ProfileBuffer* threadBuffer = nullptr;
+static thread_local bool threadHasNoBuffer = false;
+static thread_local const char* threadName = nullptr;
+
+static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+uint64_t profileNow() {
+    // Never 0, a zone started outside a capture is marked with 0
+    auto elapsed = std::chrono::steady_clock::now() - startTime;
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) + 1;
+}
+
+void profileThreadName(const char* name) {
+    threadName = name;
+    if (threadBuffer) threadBuffer->threadName.store(name, std::memory_order_relaxed);
+}
+
+void profileBeginCapture() {
+    // Buffers are made once and emptied for every capture, so a file only holds its own zones.
+    // Threads keep their buffers and names between captures.
+    if (eventStorage.empty()) {
+        eventStorage.resize(MAX_PROFILE_THREADS * EVENTS_PER_THREAD);
+        for (uint32_t i = 0; i < MAX_PROFILE_THREADS; i++) {
+            buffers[i].events = &eventStorage[i * EVENTS_PER_THREAD];
+        }
+    }
+    for (ProfileBuffer& buffer : buffers) {
+        buffer.count.store(0, std::memory_order_relaxed);
+    }
+    droppedEvents.store(0, std::memory_order_relaxed);
+    capturing.store(true, std::memory_order_release);
+}
+
+bool profileCapturing() {
+    return capturing.load(std::memory_order_acquire);
+}
+
+static void appendEvent(ProfileBuffer& buffer, const char* name, uint64_t begin, uint64_t end) {
+    size_t count = buffer.count.load(std::memory_order_relaxed);
+    if (count == EVENTS_PER_THREAD) {
+        droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.events[count] = ProfileEvent{name, begin, end};
+    // Publishes the event to profileEndCapture
+    buffer.count.store(count + 1, std::memory_order_release);
+}
+
+void profileRecord(const char* name, uint64_t begin, uint64_t end) {
+    if (!threadBuffer) {
+        if (threadHasNoBuffer) {
+            droppedEvents.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        uint32_t index = bufferCount.fetch_add(1, std::memory_order_acq_rel);
+        if (index >= MAX_PROFILE_THREADS) {
+            threadHasNoBuffer = true;
+            droppedEvents.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        threadBuffer = &buffers[index];
+        threadBuffer->threadName.store(threadName, std::memory_order_relaxed);
+    }
+
+    appendEvent(*threadBuffer, name, begin, end);
+}
+
+int profileTrack(const char* name) {
+    uint32_t index = bufferCount.fetch_add(1, std::memory_order_acq_rel);
+    if (index >= MAX_PROFILE_THREADS) return -1;
+    buffers[index].threadName.store(name, std::memory_order_relaxed);
+    return static_cast<int>(index);
+}
+
+void profileRecordOnTrack(int track, const char* name, uint64_t begin, uint64_t end) {
+    if (track < 0 || buffers[track].events == nullptr) return;
+    appendEvent(buffers[track], name, begin, end);
+}
+
+bool profileEndCapture(const char* path) {
+    capturing.store(false, std::memory_order_release);
+
+    FILE* file = std::fopen(path, "w");
+    if (!file) {
+        std::fprintf(stderr, "Could not write profile: %s\n", path);
+        return false;
+    }
+
+    // Complete events ("X") with microsecond times, one track per thread
+    std::fprintf(file, "{\"traceEvents\":[\n");
+    bool first = true;
+    size_t zones = 0;
+    uint32_t threads = std::min(bufferCount.load(std::memory_order_acquire), MAX_PROFILE_THREADS);
+    for (uint32_t t = 0; t < threads; t++) {
+        const ProfileBuffer& buffer = buffers[t];
+        const char* name = buffer.threadName.load(std::memory_order_relaxed);
+        std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s %u\"}}",
+                     first ? "" : ",\n", t + 1, name ? name : "thread", t + 1);
+        first = false;
+
+        size_t count = buffer.count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; i++) {
+            const ProfileEvent& event = buffer.events[i];
+            std::fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                         event.name, t + 1, event.begin / 1000.0, (event.end - event.begin) / 1000.0);
+        }
+        zones += count;
+    }
+    std::fprintf(file, "\n]}\n");
+    std::fclose(file);
+
+    std::printf("Profile: %zu zones on %u threads written to %s", zones, threads, path);
+    uint64_t dropped = droppedEvents.load(std::memory_order_relaxed);
+    if (dropped > 0) std::printf(", %llu dropped", static_cast<unsigned long long>(dropped));
+    std::printf("\n");
+    std::fflush(stdout);
+    return true;
+}
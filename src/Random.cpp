@@ -0,0 +1,66 @@
+#include "Random.h"
+#include <chrono>
+#include <utility>
+
+static uint64_t masterSeed = 0;
+
+// SplitMix64 finaliser, turns nearby inputs into unrelated outputs
+static uint64_t mix64(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+void setMasterSeed(uint64_t seed) {
+    masterSeed = seed;
+}
+
+uint64_t makeTimeSeed() {
+    return mix64(static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count()));
+}
+
+uint64_t deriveSeed(uint64_t stream, uint64_t index) {
+    return mixSeed(streamSeed(stream), index);
+}
+
+uint64_t streamSeed(uint64_t stream) {
+    return mix64(masterSeed ^ mix64(stream));
+}
+
+uint64_t mixSeed(uint64_t seed, uint64_t index) {
+    return mix64(seed + index);
+}
+
+uint64_t makeSquaresKey(uint64_t seed) {
+    RandomStream random(seed);
+    uint8_t digits[15];
+    for (int i = 0; i < 15; i++) digits[i] = static_cast<uint8_t>(i + 1);
+
+    // Upper half: eight different digits out of 1..15, a partial shuffle
+    uint64_t key = 0;
+    for (int i = 0; i < 8; i++) {
+        int pick = i + static_cast<int>(random.nextUint() % (15 - i));
+        std::swap(digits[i], digits[pick]);
+        key = (key << 4) | digits[i];
+    }
+
+    // Lower half: any non-zero digit that differs from the one before it, ending odd
+    uint64_t previous = digits[7];
+    for (int i = 0; i < 8; i++) {
+        uint64_t digit;
+        do {
+            digit = 1 + random.nextUint() % 15;
+        } while (digit == previous || (i == 7 && (digit & 1) == 0));
+        key = (key << 4) | digit;
+        previous = digit;
+    }
+    return key;
+}
+
+void fillEntityRandom(uint64_t key, uint32_t tick, const uint32_t* ids, size_t count, float* out) {
+    // Straight loop over plain arrays so the compiler can vectorise it
+    for (size_t i = 0; i < count; i++) {
+        out[i] = entityRandom(key, tick, ids[i]);
+    }
+}
@@ -0,0 +1,91 @@
+// Random.h
+// Every random number in the game comes from one master seed. Each system and each
+// entity gets its own stream derived from that seed, so results do not depend on
+// which thread runs an update or in what order, and a run can be replayed with --seed.
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Independent streams derived from the master seed
+enum RandomStreamId : uint64_t {
+    RANDOM_STREAM_PLACEMENT = 1,  // Spawn positions of objects and animals
+    RANDOM_STREAM_COWS      = 2,  // Per-cow behaviour
+    RANDOM_STREAM_GIRAFFES  = 3,  // Per-giraffe behaviour
+    RANDOM_STREAM_EXHAUST   = 4,  // Smoke particles
+};
+
+void setMasterSeed(uint64_t seed);
+// Seed taken from the clock, used when no --seed is given
+uint64_t makeTimeSeed();
+
+// Mix the master seed with a stream id and an index into a well spread 64-bit seed
+uint64_t deriveSeed(uint64_t stream, uint64_t index);
+// Seed of a whole stream, deriveSeed(stream, i) == mixSeed(streamSeed(stream), i)
+uint64_t streamSeed(uint64_t stream);
+// Mix an explicit seed with an index, for systems that are handed their own seed
+uint64_t mixSeed(uint64_t seed, uint64_t index);
+
+// Small generator for one stream (PCG32)
+class RandomStream {
+public:
+    explicit RandomStream(uint64_t seed = 0) { reseed(seed); }
+
+    void reseed(uint64_t seed) {
+        state = 0;
+        nextUint();
+        state += seed;
+        nextUint();
+    }
+
+    uint32_t nextUint() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint32_t shifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+        uint32_t rotation = static_cast<uint32_t>(old >> 59u);
+        return (shifted >> rotation) | (shifted << ((32u - rotation) & 31u));
+    }
+
+    // Float in [0, 1)
+    float nextFloat() { return (nextUint() >> 8) * (1.0f / 16777216.0f); }
+    // Float in [low, high)
+    float range(float low, float high) { return low + (high - low) * nextFloat(); }
+
+private:
+    uint64_t state;
+};
+
+// Counter-based generator (Squares, B. Widynski). It keeps no state: the same counter
+// and key always give the same number, so agents can draw on any thread without locks.
+inline uint32_t squares32(uint64_t counter, uint64_t key) {
+    uint64_t x = counter * key;
+    uint64_t y = x;
+    uint64_t z = y + key;
+    x = x * x + y; x = (x >> 32) | (x << 32);
+    x = x * x + z; x = (x >> 32) | (x << 32);
+    x = x * x + y; x = (x >> 32) | (x << 32);
+    return static_cast<uint32_t>((x * x + z) >> 32);
+}
+
+// Key for squares32 built from a seed the way the Squares key generator builds them: no
+// zero hex digits, the upper eight digits all different, every lower digit different from
+// its neighbour and the last one odd. Keys without that spread give visibly worse numbers.
+uint64_t makeSquaresKey(uint64_t seed);
+
+// Key for squares32 derived from an explicit seed and a round
+inline uint64_t counterKey(uint64_t seed, uint64_t round) {
+    return makeSquaresKey(mixSeed(seed, round));
+}
+
+// Float in [0, 1) for entity 'id' at the given tick
+inline float entityRandom(uint64_t key, uint32_t tick, uint32_t id) {
+    uint64_t counter = (static_cast<uint64_t>(id) << 32) | tick;
+    return (squares32(counter, key) >> 8) * (1.0f / 16777216.0f);
+}
+
+// Fill out[i] with a float in [0, 1) for entity ids[i] at the given tick
+void fillEntityRandom(uint64_t key, uint32_t tick, const uint32_t* ids, size_t count, float* out);
+
+#endif // RANDOM_H
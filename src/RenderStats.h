@@ -0,0 +1,25 @@
+// RenderStats.h
+// GL work issued this frame, counted where the calls are made, for the performance
+// overlay. GL thread only.
+
+#ifndef RENDER_STATS_H
+#define RENDER_STATS_H
+
+#include <cstdint>
+
+struct RenderStats {
+    uint32_t drawCalls = 0;
+    uint64_t triangles = 0;
+    uint32_t programBinds = 0;
+    uint32_t textureBinds = 0;
+
+    void addDraw(uint64_t drawnTriangles) {
+        drawCalls++;
+        triangles += drawnTriangles;
+    }
+};
+
+// Counts of the frame being drawn, reset by the main loop at the start of every frame
+inline RenderStats renderStats;
+
+#endif // RENDER_STATS_H
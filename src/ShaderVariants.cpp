@@ -0,0 +1,27 @@
+#include "ShaderVariants.h"
+
+void ShaderVariants::load(const char* vertexPath, const char* fragmentPath) {
+    vertexSource = Shader::readSource(vertexPath);
+    fragmentSource = Shader::readSource(fragmentPath);
+}
+
+Shader& ShaderVariants::compile(unsigned int features) {
+    std::string defines;
+    if (features & SHADER_CUBEMAP) defines += "#define USE_CUBEMAP\n";
+
+    Shader& program = programs[features];
+    program.compileSources(vertexSource, fragmentSource, "", defines);
+
+    // Fixed sampler units are set once here instead of on every draw
+    if (features & SHADER_CUBEMAP) {
+        program.use();
+        program.setInt("cubemapTexture", CUBEMAP_TEXTURE_UNIT);
+    }
+    return program;
+}
+
+Shader& ShaderVariants::get(unsigned int features) {
+    auto found = programs.find(features);
+    if (found != programs.end()) return found->second;
+    return compile(features);
+}
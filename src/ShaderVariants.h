@@ -0,0 +1,40 @@
+// ShaderVariants.h
+// One shader source built into several specialised programs, one per feature set. Every
+// feature is a #define, so a program contains only the code for the features it was built
+// with instead of branching on uniforms per fragment.
+
+#ifndef SHADER_VARIANTS_H
+#define SHADER_VARIANTS_H
+
+#include <map>
+#include <string>
+#include "shader.h"
+
+enum ShaderFeature : unsigned int {
+    SHADER_NONE = 0,
+    SHADER_CUBEMAP = 1 << 0,    // USE_CUBEMAP: reflect the sky cubemap
+};
+
+// Texture unit the cubemap is bound to. Cubemap programs point their sampler at it once
+// when they are built, so draws only bind the texture.
+const int CUBEMAP_TEXTURE_UNIT = 15;
+
+class ShaderVariants {
+public:
+    // Read the sources and expand their includes. No GL, so it can run on a loader thread.
+    void load(const char* vertexPath, const char* fragmentPath);
+
+    // Build the program for a feature set now, e.g. while loading, so get() never compiles
+    // during the game. Needs the GL thread.
+    Shader& compile(unsigned int features);
+
+    // Program for a feature set, built on first use and cached after that
+    Shader& get(unsigned int features);
+
+private:
+    std::string vertexSource;
+    std::string fragmentSource;
+    std::map<unsigned int, Shader> programs;
+};
+
+#endif // SHADER_VARIANTS_H
@@ -0,0 +1,149 @@
+#include "SpatialHash.h"
+#include <algorithm>
+#include <cmath>
+
+// Entities covering more cells than this per axis are kept in a separate list
+static const int32_t MAX_CELLS_PER_AXIS = 8;
+
+SpatialHash::SpatialHash(float cellSize)
+    : cellSize(cellSize), inverseCellSize(1.0f / cellSize) {}
+
+void SpatialHash::reserve(size_t count) {
+    // Agents smaller than a cell cover at most four cells, and the table has two buckets per reference
+    size_t references = count * 4;
+    size_t bucketCount = 64;
+    while (bucketCount < references * 2) bucketCount <<= 1;
+
+    cellRanges.reserve(count * 4);
+    entries.reserve(references);
+    bucketStart.reserve(bucketCount + 1);
+    oversized.reserve(count);
+    entityIds.reserve(count);
+    subsetBounds.reserve(count * 4);
+    if (queryStamps.size() < count) {
+        queryStamps.resize(count, currentStamp);
+    }
+}
+
+int32_t SpatialHash::cellCoord(float value) const {
+    return static_cast<int32_t>(std::floor(value * inverseCellSize));
+}
+
+uint32_t SpatialHash::bucketOf(int32_t cellX, int32_t cellZ) const {
+    // Large primes spread neighbouring cells over the table
+    uint32_t hash = (static_cast<uint32_t>(cellX) * 73856093u) ^ (static_cast<uint32_t>(cellZ) * 19349663u);
+    return hash & bucketMask;
+}
+
+void SpatialHash::build(const AgentStore& agents) {
+    build(agents.minX.data(), agents.minZ.data(), agents.maxX.data(), agents.maxZ.data(), agents.size());
+}
+
+void SpatialHash::build(const AgentStore& agents, const std::vector<uint32_t>& indices) {
+    // Gather the bounds of the subset into packed arrays, then build over those
+    size_t count = indices.size();
+    subsetBounds.resize(count * 4);
+    float* minX = subsetBounds.data();
+    float* minZ = minX + count;
+    float* maxX = minZ + count;
+    float* maxZ = maxX + count;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t agent = indices[i];
+        minX[i] = agents.minX[agent];
+        minZ[i] = agents.minZ[agent];
+        maxX[i] = agents.maxX[agent];
+        maxZ[i] = agents.maxZ[agent];
+    }
+    build(minX, minZ, maxX, maxZ, count);
+    entityIds = indices;
+}
+
+void SpatialHash::build(const float* minX, const float* minZ, const float* maxX, const float* maxZ, size_t count) {
+    entityCount = count;
+    entityIds.clear();
+    oversized.clear();
+    cellRanges.resize(count * 4);
+    if (queryStamps.size() < count) {
+        queryStamps.resize(count, currentStamp);
+    }
+
+    // Work out which cells every entity covers
+    size_t references = 0;
+    for (size_t i = 0; i < count; i++) {
+        int32_t* range = &cellRanges[i * 4];
+        range[0] = cellCoord(minX[i]);
+        range[1] = cellCoord(minZ[i]);
+        range[2] = cellCoord(maxX[i]);
+        range[3] = cellCoord(maxZ[i]);
+
+        if (range[2] - range[0] >= MAX_CELLS_PER_AXIS || range[3] - range[1] >= MAX_CELLS_PER_AXIS) {
+            oversized.push_back(static_cast<uint32_t>(i));
+            range[2] = range[0] - 1;  // Empty range, skip it below
+            continue;
+        }
+        references += static_cast<size_t>(range[2] - range[0] + 1) * (range[3] - range[1] + 1);
+    }
+
+    // Size the table to roughly two buckets per reference
+    size_t bucketCount = 64;
+    while (bucketCount < references * 2) bucketCount <<= 1;
+    bucketMask = static_cast<uint32_t>(bucketCount - 1);
+    bucketStart.assign(bucketCount + 1, 0);
+    entries.resize(references);
+
+    // Counting sort: count references per bucket, prefix sum, then scatter
+    for (size_t i = 0; i < count; i++) {
+        const int32_t* range = &cellRanges[i * 4];
+        for (int32_t cx = range[0]; cx <= range[2]; cx++)
+            for (int32_t cz = range[1]; cz <= range[3]; cz++)
+                bucketStart[bucketOf(cx, cz) + 1]++;
+    }
+    for (size_t b = 0; b < bucketCount; b++) {
+        bucketStart[b + 1] += bucketStart[b];
+    }
+    for (size_t i = 0; i < count; i++) {
+        const int32_t* range = &cellRanges[i * 4];
+        for (int32_t cx = range[0]; cx <= range[2]; cx++)
+            for (int32_t cz = range[1]; cz <= range[3]; cz++)
+                entries[bucketStart[bucketOf(cx, cz)]++] = static_cast<uint32_t>(i);
+    }
+    // The scatter advanced every start to the next bucket's start, shift them back
+    for (size_t b = bucketCount; b > 0; b--) {
+        bucketStart[b] = bucketStart[b - 1];
+    }
+    bucketStart[0] = 0;
+}
+
+void SpatialHash::query(const Hitbox& box, std::vector<uint32_t>& candidates) {
+    candidates.clear();
+    if (entityCount == 0) return;
+
+    // A new stamp marks which entities were already reported by this query
+    if (++currentStamp == 0) {
+        std::fill(queryStamps.begin(), queryStamps.end(), 0u);
+        currentStamp = 1;
+    }
+
+    for (uint32_t index : oversized) {
+        queryStamps[index] = currentStamp;
+        candidates.push_back(entityIds.empty() ? index : entityIds[index]);
+    }
+
+    int32_t minCX = cellCoord(box.minCorner.x);
+    int32_t minCZ = cellCoord(box.minCorner.z);
+    int32_t maxCX = cellCoord(box.maxCorner.x);
+    int32_t maxCZ = cellCoord(box.maxCorner.z);
+
+    for (int32_t cx = minCX; cx <= maxCX; cx++) {
+        for (int32_t cz = minCZ; cz <= maxCZ; cz++) {
+            uint32_t bucket = bucketOf(cx, cz);
+            for (uint32_t e = bucketStart[bucket]; e < bucketStart[bucket + 1]; e++) {
+                uint32_t index = entries[e];
+                if (queryStamps[index] != currentStamp) {
+                    queryStamps[index] = currentStamp;
+                    candidates.push_back(entityIds.empty() ? index : entityIds[index]);
+                }
+            }
+        }
+    }
+}
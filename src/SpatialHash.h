@@ -0,0 +1,56 @@
+// SpatialHash.h
+// Uniform grid over the ground plane used as a broadphase for moving entities.
+// The grid is rebuilt from entity bounds every tick, and queries return the entities
+// whose cells overlap a box so only those reach Hitbox::isColliding.
+
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "hitbox.hpp"
+#include "EntityStore.h"
+
+class SpatialHash {
+public:
+    SpatialHash(float cellSize = 4.0f);
+
+    // Rebuild the grid from per-entity bounds on the X/Z plane
+    void build(const float* minX, const float* minZ, const float* maxX, const float* maxZ, size_t count);
+    void build(const AgentStore& agents);
+    // Rebuild from a subset of the agents, queries then report agent indices
+    void build(const AgentStore& agents, const std::vector<uint32_t>& indices);
+
+    // Size the internal buffers for up to 'count' entities, so later builds do not allocate
+    void reserve(size_t count);
+
+    // Collect the indices of entities that may overlap the box, each index at most once.
+    // Queries reuse internal scratch state, so only one thread may query at a time.
+    void query(const Hitbox& box, std::vector<uint32_t>& candidates);
+
+    size_t size() const { return entityCount; }
+
+private:
+    float cellSize;
+    float inverseCellSize;
+    size_t entityCount = 0;
+
+    // Buckets of a power-of-two hash table, each bucket is a range in 'entries'
+    std::vector<uint32_t> bucketStart;   // Size bucketCount + 1
+    std::vector<uint32_t> entries;       // Entity indices grouped by bucket
+    std::vector<uint32_t> oversized;     // Entities too large to insert cell by cell
+    uint32_t bucketMask = 0;
+    std::vector<uint32_t> entityIds;     // Agent index of every entity, empty when built from all agents
+    std::vector<float> subsetBounds;     // minX, minZ, maxX, maxZ arrays gathered for a subset build
+
+    // Scratch state for building and de-duplicating query results
+    std::vector<int32_t> cellRanges;     // minCX, minCZ, maxCX, maxCZ per entity
+    std::vector<uint32_t> queryStamps;
+    uint32_t currentStamp = 0;
+
+    int32_t cellCoord(float value) const;
+    uint32_t bucketOf(int32_t cellX, int32_t cellZ) const;
+};
+
+#endif // SPATIAL_HASH_H
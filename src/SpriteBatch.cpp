@@ -0,0 +1,213 @@
+#include "SpriteBatch.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include "texture_loader.h"
+
+SpriteBatch::SpriteBatch(StreamBuffer& stream)
+    : shader("src/shaders/sprite_shader.vert", "src/shaders/sprite_shader.frag"), stream(stream) {
+    // Everything a frame queues fits in what is reserved here, so drawing never allocates
+    sprites.reserve(MAX_SPRITES);
+    sortKeys.reserve(MAX_SPRITES);
+    vertices.reserve(MAX_SPRITES * 4);
+
+    // Every quad is two triangles over its four corners, the same for every batch
+    std::vector<GLuint> indices;
+    indices.reserve(MAX_SPRITES * 6);
+    for (GLuint i = 0; i < MAX_SPRITES; i++) {
+        GLuint corner = i * 4;
+        indices.insert(indices.end(), {corner, corner + 1, corner + 2, corner, corner + 2, corner + 3});
+    }
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &EBO);
+    glBindVertexArray(VAO);
+
+    // Attributes point at the start of the stream, each flush draws with a base vertex
+    glBindBuffer(GL_ARRAY_BUFFER, stream.buffer());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * indices.size(), indices.data(), GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, uv));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, color));
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, distanceField));
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // Solid quads sample this, so they batch with each other like any textured quad
+    whiteTexture = loadColorTexture(255, 255, 255);
+
+    shader.use();
+    shader.setInt("image", 0);
+}
+
+SpriteBatch::~SpriteBatch() {
+    shutdown();
+}
+
+void SpriteBatch::shutdown() {
+    if (whiteTexture != 0) glDeleteTextures(1, &whiteTexture);
+    if (VAO != 0) glDeleteVertexArrays(1, &VAO);
+    if (EBO != 0) glDeleteBuffers(1, &EBO);
+    whiteTexture = VAO = EBO = 0;
+}
+
+void SpriteBatch::begin(const glm::mat4& projection) {
+    this->projection = projection;
+    sprites.clear();
+    drawCallCount = 0;
+    drawnLayer = -1;
+}
+
+void SpriteBatch::quad(GLuint texture, float x, float y, float width, float height, int layer, glm::vec4 color,
+                       glm::vec2 uvBottomLeft, glm::vec2 uvTopRight) {
+    add(layer, texture, x, y, width, height, color, uvBottomLeft, uvTopRight, 0.0f);
+}
+
+void SpriteBatch::solid(float x, float y, float width, float height, glm::vec4 color, int layer) {
+    add(layer, whiteTexture, x, y, width, height, color, glm::vec2(0.0f), glm::vec2(1.0f), 0.0f);
+}
+
+void SpriteBatch::text(TextRenderer& font, const char* text, float x, float y, float scale, glm::vec3 color, int layer) {
+    font.BeginUse();
+    holdGlyphs(font);
+    for (const char* cursor = text; *cursor;) {
+        uint32_t codepoint = TextRenderer::NextCodepoint(cursor);
+        const Character* found = font.FindGlyph(codepoint);
+        if (!found) found = font.AddGlyph(codepoint);
+        if (!found) {
+            // Every atlas shelf that would fit the glyph holds one that is queued, draw
+            // those first so their space can be reused
+            flush();
+            font.BeginUse();
+            holdGlyphs(font);
+            found = font.AddGlyph(codepoint);
+        }
+
+        const Character& ch = *found;
+        if (ch.Size.x > 0 && ch.Size.y > 0) {
+            // The atlas is stored top row first, so the top of the glyph is at UvMin.y
+            add(layer, font.AtlasTexture(), x + ch.Bearing.x * scale, y - (ch.Size.y - ch.Bearing.y) * scale,
+                ch.Size.x * scale, ch.Size.y * scale, glm::vec4(color, 1.0f), glm::vec2(ch.UvMin.x, ch.UvMax.y),
+                glm::vec2(ch.UvMax.x, ch.UvMin.y), 1.0f);
+        }
+
+        // Advance cursor to the next glyph
+        x += ch.Advance * scale;
+    }
+}
+
+void SpriteBatch::end() {
+    flush();
+
+    // Leave the 3D state as the rest of the frame expects it
+    glBindVertexArray(0);
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+}
+
+void SpriteBatch::add(int layer, GLuint texture, float x, float y, float width, float height, glm::vec4 color,
+                      glm::vec2 uvBottomLeft, glm::vec2 uvTopRight, float distanceField) {
+    if (sprites.size() == MAX_SPRITES) flush();
+    assert(layer >= drawnLayer && "queued below a layer an early flush already drew, see SpriteBatch.h");
+
+    Sprite sprite;
+    sprite.layer = layer;
+    sprite.texture = texture;
+    sprite.corners[0] = {glm::vec2(x, y), uvBottomLeft, color, distanceField};
+    sprite.corners[1] = {glm::vec2(x + width, y), glm::vec2(uvTopRight.x, uvBottomLeft.y), color, distanceField};
+    sprite.corners[2] = {glm::vec2(x + width, y + height), uvTopRight, color, distanceField};
+    sprite.corners[3] = {glm::vec2(x, y + height), glm::vec2(uvBottomLeft.x, uvTopRight.y), color, distanceField};
+    sprites.push_back(sprite);
+}
+
+void SpriteBatch::holdGlyphs(TextRenderer& font) {
+    for (int i = 0; i < heldFontCount; i++) {
+        if (heldFonts[i] == &font) return;
+    }
+    assert(heldFontCount < MAX_FONTS && "too many fonts in one batch");
+    if (heldFontCount == MAX_FONTS) return;
+    heldFonts[heldFontCount++] = &font;
+    font.HoldGlyphs();
+}
+
+void SpriteBatch::releaseGlyphs() {
+    for (int i = 0; i < heldFontCount; i++) {
+        heldFonts[i]->ReleaseGlyphs();
+    }
+    heldFontCount = 0;
+}
+
+void SpriteBatch::flush() {
+    if (sprites.empty()) {
+        releaseGlyphs();
+        return;
+    }
+
+    // Layer, then texture, then submission order. The index makes every key unique, so
+    // quads sharing a layer and texture keep the order they were queued in.
+    sortKeys.clear();
+    for (size_t i = 0; i < sprites.size(); i++) {
+        const Sprite& sprite = sprites[i];
+        sortKeys.push_back(static_cast<uint64_t>(sprite.layer & 0xFF) << 56 |
+                           static_cast<uint64_t>(sprite.texture & 0xFFFFFF) << 32 | i);
+    }
+    std::sort(sortKeys.begin(), sortKeys.end());
+
+    vertices.clear();
+    for (uint64_t key : sortKeys) {
+        const Sprite& sprite = sprites[key & 0xFFFFFFFF];
+        vertices.insert(vertices.end(), sprite.corners, sprite.corners + 4);
+    }
+
+    // Aligned to whole vertices, so the offset is a base vertex
+    size_t offset;
+    void* data = stream.map(sizeof(SpriteVertex) * vertices.size(), sizeof(SpriteVertex), offset);
+    if (!data) {
+        sprites.clear();
+        releaseGlyphs();
+        return;
+    }
+    std::memcpy(data, vertices.data(), sizeof(SpriteVertex) * vertices.size());
+    if (!stream.unmap()) {
+        sprites.clear();
+        releaseGlyphs();
+        return;
+    }
+    GLint baseVertex = static_cast<GLint>(offset / sizeof(SpriteVertex));
+
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    shader.use();
+    shader.setMat4("projection", projection);
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(VAO);
+
+    // One draw per run of quads with the same texture
+    size_t runStart = 0;
+    while (runStart < sortKeys.size()) {
+        GLuint texture = sprites[sortKeys[runStart] & 0xFFFFFFFF].texture;
+        size_t runEnd = runStart + 1;
+        while (runEnd < sortKeys.size() && sprites[sortKeys[runEnd] & 0xFFFFFFFF].texture == texture) runEnd++;
+
+        glBindTexture(GL_TEXTURE_2D, texture);
+        renderStats.textureBinds++;
+        glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>((runEnd - runStart) * 6), GL_UNSIGNED_INT,
+                                 (void*)(runStart * 6 * sizeof(GLuint)), baseVertex);
+        drawCallCount++;
+        renderStats.addDraw((runEnd - runStart) * 2);
+        runStart = runEnd;
+    }
+
+    sprites.clear();
+    drawnLayer = std::max(drawnLayer, static_cast<int>(sortKeys.back() >> 56));
+    releaseGlyphs();
+}
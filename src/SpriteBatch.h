@@ -0,0 +1,95 @@
+// SpriteBatch.h
+// Immediate mode 2D renderer for the menu, HUD and end game screens. Textured quads,
+// solid quads and text are queued between begin() and end(), then sorted by layer and
+// texture and written once into the frame's part of a StreamBuffer, with one draw call
+// per run of quads that share a texture. Within a layer quads are only kept in order
+// when they share a texture, so anything that must be drawn on top goes on a higher layer.
+//
+// A batch is drawn early, before end(), only when it outgrows MAX_SPRITES quads or its
+// text needs more glyphs than the font atlas holds at once. Quads queued after that are
+// drawn over it, so a debug build asserts that none of them is on a lower layer.
+
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "shader.h"
+#include "StreamBuffer.h"
+#include "TextRenderer.h"
+
+enum SpriteLayer {
+    LAYER_BACKGROUND,
+    LAYER_UI,
+    LAYER_TEXT
+};
+
+class SpriteBatch {
+public:
+    static const int MAX_SPRITES = 2048;  // Quads per upload, more are drawn in several flushes
+    static const int MAX_FONTS = 4;       // Fonts one batch can draw text with
+
+    // Vertices are written to 'stream', which must be an array buffer
+    explicit SpriteBatch(StreamBuffer& stream);
+    ~SpriteBatch();
+    SpriteBatch(const SpriteBatch&) = delete;
+    SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+    void begin(const glm::mat4& projection);
+    // Texture coordinates default to the whole image, bottom left to top right
+    void quad(GLuint texture, float x, float y, float width, float height, int layer = LAYER_BACKGROUND,
+              glm::vec4 color = glm::vec4(1.0f), glm::vec2 uvBottomLeft = glm::vec2(0.0f),
+              glm::vec2 uvTopRight = glm::vec2(1.0f));
+    void solid(float x, float y, float width, float height, glm::vec4 color, int layer = LAYER_UI);
+    // UTF-8 text with its baseline starting at (x, y)
+    void text(TextRenderer& font, const char* text, float x, float y, float scale, glm::vec3 color,
+              int layer = LAYER_TEXT);
+    // Draw everything queued
+    void end();
+
+    // Draw calls made since begin()
+    int drawCalls() const { return drawCallCount; }
+
+    // Delete the GL objects while the context is still current, the destructor does
+    // nothing after this
+    void shutdown();
+
+private:
+    struct SpriteVertex {
+        glm::vec2 position;
+        glm::vec2 uv;
+        glm::vec4 color;
+        float distanceField;  // 1 for text, the texture holds a signed distance field
+    };
+    struct Sprite {
+        int layer;
+        GLuint texture;
+        SpriteVertex corners[4];  // Bottom left, bottom right, top right, top left
+    };
+
+    Shader shader;
+    StreamBuffer& stream;
+    GLuint VAO = 0, EBO = 0;
+    GLuint whiteTexture = 0;
+    glm::mat4 projection = glm::mat4(1.0f);
+
+    std::vector<Sprite> sprites;
+    std::vector<uint64_t> sortKeys;
+    std::vector<SpriteVertex> vertices;  // Sorted corners, staged for the upload
+    int drawCallCount = 0;
+    int drawnLayer = -1;                 // Highest layer an early flush has drawn since begin()
+
+    // Fonts whose glyphs queued quads point at, their atlas space is held until the flush
+    TextRenderer* heldFonts[MAX_FONTS];
+    int heldFontCount = 0;
+
+    void add(int layer, GLuint texture, float x, float y, float width, float height, glm::vec4 color,
+             glm::vec2 uvBottomLeft, glm::vec2 uvTopRight, float distanceField);
+    void holdGlyphs(TextRenderer& font);
+    void releaseGlyphs();
+    void flush();
+};
+
+#endif // SPRITE_BATCH_H
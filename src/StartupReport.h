@@ -0,0 +1,46 @@
+// StartupReport.h
+// Splits the time from launch to the first interactive frame into named phases and
+// prints how long each one took, to see where startup time goes.
+
+#ifndef STARTUP_REPORT_H
+#define STARTUP_REPORT_H
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+class StartupReport {
+public:
+    StartupReport() : start(Clock::now()), phaseStart(start) {}
+
+    // End the phase running since the last call (or since construction) under this name
+    void phase(const char* name) {
+        Clock::time_point now = Clock::now();
+        phases.push_back(Phase{name, std::chrono::duration<double>(now - phaseStart).count()});
+        phaseStart = now;
+    }
+
+    double totalSeconds() const { return std::chrono::duration<double>(phaseStart - start).count(); }
+
+    void print() const {
+        double total = totalSeconds();
+        std::printf("Startup took %.1f ms:\n", total * 1000.0);
+        for (const Phase& p : phases) {
+            std::printf("  %-16s %8.1f ms %5.1f%%\n", p.name, p.seconds * 1000.0, total > 0.0 ? 100.0 * p.seconds / total : 0.0);
+        }
+        std::fflush(stdout);
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    struct Phase {
+        const char* name;
+        double seconds;
+    };
+
+    Clock::time_point start;
+    Clock::time_point phaseStart;
+    std::vector<Phase> phases;
+};
+
+#endif // STARTUP_REPORT_H
@@ -0,0 +1,78 @@
+#include "StreamBuffer.h"
+
+StreamBuffer::StreamBuffer(GLenum target, size_t capacity)
+    : target(target), regionSize(capacity / FRAMES_IN_FLIGHT / 256 * 256) {
+    glGenBuffers(1, &bufferId);
+    glBindBuffer(target, bufferId);
+    glBufferData(target, regionSize * FRAMES_IN_FLIGHT, NULL, GL_STREAM_DRAW);
+}
+
+StreamBuffer::~StreamBuffer() {
+    shutdown();
+}
+
+void StreamBuffer::shutdown() {
+    for (GLsync& fence : fences) {
+        if (fence) glDeleteSync(fence);
+        fence = 0;
+    }
+    if (bufferId != 0) glDeleteBuffers(1, &bufferId);
+    bufferId = 0;
+}
+
+void* StreamBuffer::map(size_t size, size_t alignment, size_t& offset) {
+    if (size > regionSize) return nullptr;
+
+    // The first write to a region waits for the frame that used it last
+    if (fences[region]) waitAndDelete(fences[region]);
+
+    size_t base = region * regionSize;
+    size_t start = (base + head + alignment - 1) / alignment * alignment;
+    if (start + size > base + regionSize) {
+        // This frame filled its region, start it over once the draws from it are done
+        GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        waitAndDelete(fence);
+        start = (base + alignment - 1) / alignment * alignment;
+        if (start + size > base + regionSize) return nullptr;
+    }
+
+    // Nothing the GPU reads overlaps the range, so the driver does not have to check
+    glBindBuffer(target, bufferId);
+    void* data = glMapBufferRange(target, start, size,
+                                  GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (!data) return nullptr;
+
+    head = start + size - base;
+    bytes += size;
+    offset = start;
+    return data;
+}
+
+bool StreamBuffer::unmap() {
+    glBindBuffer(target, bufferId);
+    return glUnmapBuffer(target) == GL_TRUE;
+}
+
+void StreamBuffer::endFrame() {
+    if (head > 0) fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    region = (region + 1) % FRAMES_IN_FLIGHT;
+    head = 0;
+
+    lastBytes = bytes;
+    lastWaits = waits;
+    bytes = 0;
+    waits = 0;
+}
+
+void StreamBuffer::waitAndDelete(GLsync& fence) {
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        // The GPU is behind, block in 1 ms steps
+        waits++;
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        } while (result == GL_TIMEOUT_EXPIRED);
+    }
+    glDeleteSync(fence);
+    fence = 0;
+}
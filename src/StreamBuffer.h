@@ -0,0 +1,55 @@
+// StreamBuffer.h
+// One large GL buffer for data rewritten every frame. Each frame writes into its own
+// region of the buffer, mapped with GL_MAP_UNSYNCHRONIZED_BIT so the driver never stalls
+// or orphans on the map. A fence at the end of every frame marks when the GPU is done
+// with that frame's region, and the region is only written again after its fence.
+
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <glad/glad.h>
+#include <cstddef>
+
+class StreamBuffer {
+public:
+    static const int FRAMES_IN_FLIGHT = 3;  // Frames the GPU may still be reading
+
+    StreamBuffer(GLenum target, size_t capacity);
+    ~StreamBuffer();
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // Map 'size' bytes for writing. The returned range starts 'offset' bytes into the
+    // buffer, at a multiple of 'alignment'. nullptr when size is more than a frame's region.
+    void* map(size_t size, size_t alignment, size_t& offset);
+    // False when the driver lost the data, the range must not be drawn from then
+    bool unmap();
+    // Fence this frame's region and move on to the next one. Once per frame, after the
+    // frame's last draw from the buffer.
+    void endFrame();
+    // Delete the buffer and fences while the GL context is still current, the destructor
+    // does nothing after this
+    void shutdown();
+
+    GLuint buffer() const { return bufferId; }
+    // Bytes mapped and waits on the GPU in the last finished frame
+    size_t frameBytes() const { return lastBytes; }
+    int frameWaits() const { return lastWaits; }
+
+private:
+    GLenum target;
+    GLuint bufferId = 0;
+    size_t regionSize = 0;
+    GLsync fences[FRAMES_IN_FLIGHT] = {};
+    int region = 0;
+    size_t head = 0;  // Bytes used in the current region
+
+    size_t bytes = 0;
+    int waits = 0;
+    size_t lastBytes = 0;
+    int lastWaits = 0;
+
+    void waitAndDelete(GLsync& fence);
+};
+
+#endif // STREAM_BUFFER_H
@@ -1,61 +1,57 @@
 #ifndef TEXTRENDERER_H
 #define TEXTRENDERER_H
 
-#include <map>
+#include <cstdint>
 #include <string>
-#include <glm/glm.hpp>
-#include "shader.h"
+#include "GlyphCache.h"
 #include "../dependencies/include/stb_truetype.h"
 
-struct Character {
-    GLuint TextureID;   // ID handle of the glyph texture
-    glm::ivec2 Size;    // Size of glyph
-    glm::vec2 Bearing;  // Offset from baseline to left/top of glyph
-    float Advance;      // Offset to advance to next glyph
-};
-
+// Font and glyph cache for text. The quads are drawn by SpriteBatch::text.
 class TextRenderer {
 public:
     // Constructor with fontSize parameter
-    TextRenderer(const char* fontFilePath, Shader& shader, float fontSize = 24.0f);
+    TextRenderer(const char* fontFilePath, float fontSize = 24.0f);
 
     // Destructor
     ~TextRenderer();
 
-    // Render text at the given position, scale, and color
-    void RenderText(const std::string& text, float x, float y, float scale, glm::vec3 color);
-
-    // Calculate the width of the text string
+    // Calculate the width of the UTF-8 text string
     float CalculateTextWidth(const std::string& text, float scale);
 
-    // Set the projection matrix
-    void SetProjection(glm::mat4 projection);
-
-    // Begin using the text shader
-    void Use();
+    // Glyphs found from here on count as used by one string, for the cache's eviction order
+    void BeginUse() { glyphs.beginUse(); }
+    // Cached glyph, or nullptr until AddGlyph rasterises it
+    const Character* FindGlyph(uint32_t codepoint) { return glyphs.find(codepoint); }
+    // May evict atlas space that is not held, nullptr when only held space is left
+    const Character* AddGlyph(uint32_t codepoint) { return glyphs.add(codepoint); }
+    // Keep the atlas space of glyphs used from this string on until ReleaseGlyphs
+    void HoldGlyphs() { glyphs.hold(); }
+    void ReleaseGlyphs() { glyphs.release(); }
+    GLuint AtlasTexture() const { return glyphs.texture(); }
+    // Delete the atlas texture before the GL context goes, glyphs are still saved on destruction
+    void Shutdown() { glyphs.deleteTexture(); }
+
+    // Decode one UTF-8 sequence and move past it. Malformed bytes decode to U+FFFD.
+    static uint32_t NextCodepoint(const char*& cursor);
 
 private:
-    // Shader for rendering text
-    Shader& textShader;
-
-    // Holds all state information relevant to a character as loaded using stb_truetype
-    std::map<char, Character> Characters;
-
-    // Render state
-    unsigned int VAO, VBO;
+    // Signed distance fields of the glyphs in use, rasterised the first time they are drawn.
+    // The field is made at the font size and stays sharp when text is drawn larger or smaller.
+    GlyphCache glyphs;
+    std::string cachePath;
+    uint32_t fontHash = 0;
 
     // stb_truetype font info
     stbtt_fontinfo font;
-    unsigned char* fontBuffer;
+    unsigned char* fontBuffer = nullptr;
+    size_t fontBufferSize = 0;
 
     // Load font from file
     bool LoadFont(const char* fontFilePath);
 
-    // Load character glyphs with fontSize
-    void LoadCharacters(float fontSize);
-
-    // Configure VAO/VBO for texture quads
-    void SetupRenderData();
+    // Set up the glyph cache with fontSize, warm started from the glyphs resident when the
+    // last launch exited
+    void LoadCharacters(const char* fontFilePath, float fontSize);
 };
 
 #endif // TEXTRENDERER_H
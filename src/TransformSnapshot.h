@@ -0,0 +1,59 @@
+// TransformSnapshot.h
+// Transforms published by the simulation for rendering. The simulation fills the back
+// buffer after its ticks and publishes it with one atomic index flip; rendering only
+// reads the front buffer, so neither side takes a lock and a frame never mixes two ticks.
+
+#ifndef TRANSFORM_SNAPSHOT_H
+#define TRANSFORM_SNAPSHOT_H
+
+#include <atomic>
+#include <vector>
+#include <glm/glm.hpp>
+#include "EntityStore.h"
+
+// Two copies of T. One writer fills back() and calls publish(), readers use front().
+// The writer must not publish again while a reader still uses the old front buffer,
+// which holds as long as the simulation publishes at most once per rendered frame.
+template <typename T>
+class DoubleBuffer {
+public:
+    T& back() { return buffers[1 - frontIndex.load(std::memory_order_acquire)]; }
+    const T& front() const { return buffers[frontIndex.load(std::memory_order_acquire)]; }
+
+    // Make the back buffer the new front buffer
+    void publish() { frontIndex.store(1 - frontIndex.load(std::memory_order_relaxed), std::memory_order_release); }
+
+private:
+    T buffers[2];
+    std::atomic<int> frontIndex{0};
+};
+
+// Position and heading of every agent at the last two ticks
+struct AgentTransforms {
+    std::vector<float> prevX, prevY, prevZ, prevRotation;
+    std::vector<float> x, y, z, rotation;
+
+    // Copy the transforms out of the simulation arrays
+    void capture(const AgentStore& agents) {
+        prevX = agents.prevPosX;
+        prevY = agents.prevPosY;
+        prevZ = agents.prevPosZ;
+        prevRotation = agents.prevRotation;
+        x = agents.posX;
+        y = agents.posY;
+        z = agents.posZ;
+        rotation = agents.totalRotation;
+    }
+
+    size_t size() const { return x.size(); }
+
+    // Transforms blended 'alpha' of the way from the previous to the current tick
+    glm::vec3 position(size_t i, float alpha) const {
+        return glm::mix(glm::vec3(prevX[i], prevY[i], prevZ[i]), glm::vec3(x[i], y[i], z[i]), alpha);
+    }
+    float heading(size_t i, float alpha) const {
+        return prevRotation[i] + (rotation[i] - prevRotation[i]) * alpha;
+    }
+};
+
+#endif // TRANSFORM_SNAPSHOT_H
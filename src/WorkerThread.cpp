@@ -0,0 +1,52 @@
+#include "WorkerThread.h"
+#include "AllocationTracker.h"
+
+WorkerThread::WorkerThread(std::function<void()> job) : job(std::move(job)), thread(&WorkerThread::loop, this) {}
+
+WorkerThread::~WorkerThread() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    thread.join();
+}
+
+void WorkerThread::start() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        started = true;
+        forbidAllocations = allocationsForbidden();
+    }
+    changed.notify_all();
+}
+
+void WorkerThread::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this]() { return !started; });
+}
+
+bool WorkerThread::running() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return started;
+}
+
+void WorkerThread::loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [this]() { return started || stopping; });
+        if (stopping) return;
+
+        bool forbid = forbidAllocations;
+        lock.unlock();
+        {
+            NoAllocationScope scope(forbid);
+            job();
+        }
+        lock.lock();
+
+        started = false;
+        changed.notify_all();
+    }
+}
@@ -0,0 +1,38 @@
+// WorkerThread.h
+// One long-lived thread that runs the same job each time it is started. Used instead of a
+// std::async per frame, which allocates shared state and can start a new thread every time.
+
+#ifndef WORKER_THREAD_H
+#define WORKER_THREAD_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class WorkerThread {
+public:
+    explicit WorkerThread(std::function<void()> job);
+    ~WorkerThread();
+    WorkerThread(const WorkerThread&) = delete;
+    WorkerThread& operator=(const WorkerThread&) = delete;
+
+    // Run the job once on the thread. The previous run must have been waited for.
+    void start();
+    // Block until the started run has finished, returns at once when nothing is running
+    void wait();
+    bool running();
+
+private:
+    std::function<void()> job;
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool started = false;           // A run was requested and has not finished yet
+    bool stopping = false;
+    bool forbidAllocations = false; // The starting thread's NoAllocationScope, applied to the run
+    std::thread thread;
+
+    void loop();
+};
+
+#endif // WORKER_THREAD_H
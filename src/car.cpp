@@ -4,12 +4,24 @@
 
 
 Car::Car(Model& carModel) 
-    :model(carModel), position(0.0f, 0.0f, 0.0f), speed(0.0f), maxSpeed(30.0f), steeringAngle(0.0f), turningSpeed(90.0f), collisionInt(0),
-    hitbox(carModel.calculateHitbox()) 
-    {}
+    :model(carModel), position(0.0f, 0.0f, 0.0f), speed(0.0f), maxSpeed(30.0f), steeringAngle(0.0f), prevPosition(0.0f, 0.0f, 0.0f), prevSteeringAngle(0.0f), turningSpeed(90.0f), collisionInt(0),
+    hitbox(carModel.getLocalBounds()) 
+    {
+        capture();
+        publish();
+    }
     
 
-void Car::update(float deltaTime, GLFWwindow* window, ExhaustSystem& exhaustSystem, std::vector<Hitbox>& environmentHitboxes, std::vector<Hitbox>& wallHitboxes) {
+CarInput Car::readInput(GLFWwindow* window) {
+    CarInput input;
+    input.accelerate = glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS;
+    input.brake = glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS;
+    input.steerLeft = glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS;
+    input.steerRight = glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS;
+    return input;
+}
+
+void Car::update(float deltaTime, const CarInput& input, const CollisionWorld& world) {
     static float deceleration = 15.0f;   // Deceleration rate when W key is released
     static float brakeMultiplier = 40.0f; // Braking deceleration when S key is pressed
     float tau = 5.0f;                    // Time constant for acceleration (adjust this for acceleration speed)
@@ -21,13 +33,17 @@ void Car::update(float deltaTime, GLFWwindow* window, ExhaustSystem& exhaustSyst
     bool braking = false;                // Check if braking is applied
     float accelerationMultiplier = 6.0f;  // Multiplier for forward acceleration
 
+    // Remember where the car was so rendering can blend towards the new state
+    prevPosition = position;
+    prevSteeringAngle = steeringAngle;
+
     glm::vec3 newPosition = position;  // Predict the new position based on current speed
 
     // Extract the car's forward direction from the transformation matrix
     glm::vec3 forwardDirection = getForwardDirection();
 
     // Update car position based on direction and speed
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
+    if (input.accelerate) {
         // Car is already moving forward, keep the current speed and apply exponential acceleration
         float currentSpeed = speed;
 
@@ -37,7 +53,7 @@ void Car::update(float deltaTime, GLFWwindow* window, ExhaustSystem& exhaustSyst
         forward = true;
         newPosition -= forwardDirection * speed * deltaTime;
     } 
-    else if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
+    else if (input.brake) {
         if (speed > 0.0f) {
             // Car is moving forward, so apply braking first
             forward = true;
@@ -77,7 +93,7 @@ void Car::update(float deltaTime, GLFWwindow* window, ExhaustSystem& exhaustSyst
     }
 
     // Handle car turning (only allow turning while moving forward or reverse)
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS && (forward || reverse)) {
+    if (input.steerLeft && (forward || reverse)) {
         if (forward) {
             steeringAngle += turningSpeed * deltaTime;  // Move left when moving forward
         } else if (reverse) {
@@ -86,7 +102,7 @@ void Car::update(float deltaTime, GLFWwindow* window, ExhaustSystem& exhaustSyst
         isTurning = true;
     }
 
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS && (forward || reverse)) {
+    if (input.steerRight && (forward || reverse)) {
         if (forward) {
             steeringAngle -= turningSpeed * deltaTime;  // Move right when moving forward
         } else if (reverse) {
@@ -95,22 +111,13 @@ void Car::update(float deltaTime, GLFWwindow* window, ExhaustSystem& exhaustSyst
         isTurning = true;
     }
 
-    // Update the particle system (smoke emission)
-    exhaustSystem.update(deltaTime, position);  // The exhaust position is relative to the car's position
-    
     // Check for collisions with the environment
-    bool collision = false;
     Hitbox newHitbox = hitbox;
     glm::vec3 offset = newPosition - position;
     newHitbox.minCorner += offset;
     newHitbox.maxCorner += offset;
 
-    for (const auto& envHitbox : environmentHitboxes) {
-        if (newHitbox.isColliding(envHitbox)) {
-            collision = true;
-            break;
-        }
-    }
+    bool collision = world.overlapsAny(newHitbox, COLLISION_ENVIRONMENT);
     
     
 
@@ -139,12 +146,9 @@ void Car::update(float deltaTime, GLFWwindow* window, ExhaustSystem& exhaustSyst
     hitbox = Hitbox(boxMin, boxMax);
 
     // Check for collisions with the walls
-    for (const auto& wallHitbox : wallHitboxes) {
-        if (hitbox.isColliding(wallHitbox)) {
-            //std::cout << "Car and wall collided!" << std::endl;
-            speed = 0.0f;
-            break;
-        }
+    if (world.overlapsAny(hitbox, COLLISION_WALL)) {
+        //std::cout << "Car and wall collided!" << std::endl;
+        speed = 0.0f;
     }
 
     
@@ -155,13 +159,15 @@ void Car::update(float deltaTime, GLFWwindow* window, ExhaustSystem& exhaustSyst
 
 
 
-void Car::draw(Shader& shader) {
+void Car::draw(Shader& shader, float alpha) {
     glm::mat4 carModelMatrix = glm::mat4(1.0f);
-    carModelMatrix = glm::translate(carModelMatrix, position); // Position of car
+    const CarTransform& snapshot = transforms.front();
+    carModelMatrix = glm::translate(carModelMatrix, getRenderPosition(alpha)); // Position of car
 
     // Rotate the car 180 degrees along y axis to flip then apply the steering angle
     carModelMatrix = glm::rotate(carModelMatrix, glm::radians(180.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-    carModelMatrix = glm::rotate(carModelMatrix, glm::radians(steeringAngle), glm::vec3(0.0f, 1.0f, 0.0f));
+    float renderSteeringAngle = snapshot.prevSteeringAngle + (snapshot.steeringAngle - snapshot.prevSteeringAngle) * alpha;
+    carModelMatrix = glm::rotate(carModelMatrix, glm::radians(renderSteeringAngle), glm::vec3(0.0f, 1.0f, 0.0f));
 
     carModelMatrix = glm::scale(carModelMatrix, glm::vec3(0.5f, 0.5f, 0.5f)); // Scale car if necessary
 
@@ -183,6 +189,29 @@ float Car::getSpeed() const{
     return speed;
 }
 
+glm::vec3 Car::getRenderPosition(float alpha) const {
+    const CarTransform& snapshot = transforms.front();
+    return glm::mix(snapshot.prevPosition, snapshot.position, alpha);
+}
+
+glm::vec3 Car::getRenderForwardDirection(float alpha) const {
+    const CarTransform& snapshot = transforms.front();
+    float angle = glm::radians(snapshot.prevSteeringAngle + (snapshot.steeringAngle - snapshot.prevSteeringAngle) * alpha);
+    return glm::vec3(sin(angle), 0.0f, cos(angle));
+}
+
+void Car::capture() {
+    CarTransform& snapshot = transforms.back();
+    snapshot.prevPosition = prevPosition;
+    snapshot.position = position;
+    snapshot.prevSteeringAngle = prevSteeringAngle;
+    snapshot.steeringAngle = steeringAngle;
+}
+
+void Car::publish() {
+    transforms.publish();
+}
+
 Hitbox Car::getHitbox() const {
     return hitbox;
 }
@@ -196,7 +225,11 @@ void Car::reset() {
     position = glm::vec3(0.0f, 0.0f, 0.0f);
     speed = 0.0f;
     steeringAngle = 0.0f;
+    prevPosition = position;
+    prevSteeringAngle = steeringAngle;
     collisionInt = 0;
-    // Recalculate hitbox
-    hitbox = model.calculateHitbox();
+    // Restore the hitbox from the cached model bounds
+    hitbox = model.getLocalBounds();
+    capture();
+    publish();
 }
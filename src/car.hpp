@@ -7,8 +7,25 @@
 
 #include "model.hpp"
 #include "shader.h"
-#include "ExhaustSystem.h"
 #include "hitbox.hpp"
+#include "CollisionWorld.h"
+#include "TransformSnapshot.h"
+
+// Driving keys sampled on the main thread, so the simulation never calls GLFW
+struct CarInput {
+    bool accelerate = false;  // W
+    bool brake = false;       // S
+    bool steerLeft = false;   // A
+    bool steerRight = false;  // D
+};
+
+// Car transform at the last two ticks, published for rendering
+struct CarTransform {
+    glm::vec3 prevPosition{0.0f};
+    glm::vec3 position{0.0f};
+    float prevSteeringAngle = 0.0f;
+    float steeringAngle = 0.0f;
+};
 
 class Car {
 public:
@@ -16,16 +33,24 @@ public:
     Car(Model& model);
 
     // Functions
-    void update(float deltaTime, GLFWwindow* window, ExhaustSystem& exhaustSystem, std::vector<Hitbox>& environmentHitboxes, std::vector<Hitbox>& wallHitboxes);
-    void draw(Shader& shader);
+    static CarInput readInput(GLFWwindow* window);
+    void update(float deltaTime, const CarInput& input, const CollisionWorld& world);
+    void draw(Shader& shader, float alpha = 1.0f);  // alpha blends from the previous to the current tick
     void gameHit();
     void reset();
+    // Copy this tick's transform into the back buffer (simulation side)
+    void capture();
+    // Flip the captured transform to the front (render side, while the simulation is idle)
+    void publish();
 
 
     // Getters 
     glm::vec3 getPosition() const;
     glm::vec3 getForwardDirection() const;
     float getSpeed() const;
+    // Published position and facing blended between the previous and current tick for rendering
+    glm::vec3 getRenderPosition(float alpha) const;
+    glm::vec3 getRenderForwardDirection(float alpha) const;
     Hitbox getHitbox() const;
 
 private:
@@ -34,11 +59,15 @@ private:
     float speed;
     float maxSpeed;
     float steeringAngle;
+    glm::vec3 prevPosition;    // Position at the start of the tick
+    float prevSteeringAngle;   // Steering angle at the start of the tick
     float turningSpeed;
     int collisionInt;
 
     // Hitbox for collision detection
     Hitbox hitbox;
+
+    DoubleBuffer<CarTransform> transforms;  // What the renderer and camera read
 };
 
 #endif // CAR_HPP
\ No newline at end of file
@@ -6,24 +6,36 @@ Cubemap::Cubemap(std::vector<std::string> faces) {
 }
 
 unsigned int Cubemap::loadCubemap(std::vector<std::string> faces) {
-    unsigned int textureID;
+    loadFaces(faces);
+    upload();
+    return textureID;
+}
+
+void Cubemap::loadFaces(const std::vector<std::string>& faces) {
+    decodedFaces.clear();
+    for (const std::string& face : faces) {
+        decodedFaces.push_back(decodeImage(face));
+        if (!decodedFaces.back().pixels) {
+            std::cout << "Cubemap texture failed to load at path: " << face << std::endl;
+        }
+    }
+}
+
+void Cubemap::upload() {
     glGenTextures(1, &textureID);
     glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
 
-    int width, height, nrChannels;
-    for (unsigned int i = 0; i < faces.size(); i++) {
-        unsigned char *data = stbi_load(faces[i].c_str(), &width, &height, &nrChannels, 0);
-        if (data) {
+    for (unsigned int i = 0; i < decodedFaces.size(); i++) {
+        ImageData& face = decodedFaces[i];
+        if (face.pixels) {
             // Load each face of the cubemap into the corresponding target
             glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
-                         0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data
+                         0, GL_RGB, face.width, face.height, 0, GL_RGB, GL_UNSIGNED_BYTE, face.pixels
             );
-            stbi_image_free(data);  // Free the image memory after loading
-        } else {
-            std::cout << "Cubemap texture failed to load at path: " << faces[i] << std::endl;
-            stbi_image_free(data);
         }
+        freeImage(face);  // Free the image memory after loading
     }
+    decodedFaces.clear();
 
     // Set texture parameters
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -31,8 +43,6 @@ unsigned int Cubemap::loadCubemap(std::vector<std::string> faces) {
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-
-    return textureID;
 }
 
 void Cubemap::draw(Shader& shader) {
@@ -40,6 +50,7 @@ void Cubemap::draw(Shader& shader) {
     shader.setInt("skybox", 0);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+    renderStats.textureBinds++;
 }
 
 unsigned int Cubemap::getTextureID() {
@@ -9,17 +9,23 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include "shader.h"
+#include "texture_loader.h"
 
 class Cubemap {
 
 public:
+    Cubemap() = default;
     Cubemap(std::vector<std::string> faces);
+    // Decode the faces on any thread, then create the texture on the GL thread
+    void loadFaces(const std::vector<std::string>& faces);
+    void upload();
     void draw(Shader& shader);
     unsigned int getTextureID();
 
 private:
     unsigned int loadCubemap(std::vector<std::string> faces);
-    unsigned int textureID;
+    unsigned int textureID = 0;
+    std::vector<ImageData> decodedFaces;  // Waiting for upload
 };
 
 #endif // CUBEMAP_HPP
\ No newline at end of file
@@ -10,15 +10,12 @@
 #include <glm/gtc/matrix_transform.hpp> // For transformations
 #include <glm/gtc/type_ptr.hpp>         // For converting matrices to OpenGL-compatible pointers
 #include <cmath>
-#include <random>
+#include <cstdlib>
 #include <thread>  // Include this for std::this_thread::sleep_for
 #include <chrono>  // Include this for std::chrono::milliseconds
 #include <unordered_set>
 #include <iostream>
 #include <stb_image.h>
-#include <future>
-#include <sstream>
-#include <iomanip>
 
 #include "shader.h"
 #include "controls.hpp"
@@ -26,10 +23,27 @@
 #include "model.hpp"
 #include "globals.hpp"
 #include "car.hpp"
-#include "Cow_Character.h"
-#include "Giraffe_Character.h"
+#include "CowSystem.h"
+#include "GiraffeSystem.h"
+#include "SpatialHash.h"
+#include "CollisionWorld.h"
+#include "FixedTimestep.h"
+#include "Random.h"
+#include "GameConfig.h"
+#include "PoissonDisk.h"
+#include "StartupReport.h"
 #include "ExhaustSystem.h"
+#include "AllocationTracker.h"
+#include "Log.h"
+#include "Profiler.h"
+#include "GpuProfiler.h"
+#include "FrameArena.h"
+#include "WorkerThread.h"
+#include "AssetLoader.h"
+#include "ShaderVariants.h"
 #include "TextRenderer.h"   // To show the game score
+#include "SpriteBatch.h"
+#include "PerfOverlay.h"
 #include "cubemap.hpp"
 
 // Define the GameState enum before using it
@@ -54,6 +68,12 @@ bool gameStarted = false;
 bool doOnce = true;
 bool cowInflated = false;
 
+// Random stream for object and animal placement, seeded from the master seed in main
+RandomStream placementRandom;
+
+// Entity counts, map size and spacing, read from the command line in main
+GameConfig gameConfig;
+
 struct Vec3Hash {
     std::size_t operator()(const glm::vec3& v) const {
         return std::hash<float>()(v.x) ^ std::hash<float>()(v.y) ^ std::hash<float>()(v.z);
@@ -120,40 +140,13 @@ void setLightingAndObjectProperties(Shader& shader) {
     shader.setVec3("objectColor", objectColor);
 }
 
-// Function to check the distance between two positions
-bool isPositionValid(const glm::vec3& newPosition, const std::vector<glm::vec3>& existingPositions, float minDistance) {
-    for (const auto& pos : existingPositions) {
-        float distance = glm::distance(newPosition, pos);
-        if (distance < minDistance) {
-            return false;
-        }
-    }
-    return true;
-}
-
-// Function to generate pseudo-random object positions with at least 5 units of distance between them
+// Function to generate pseudo-random object positions with at least minDistance between them
 std::vector<glm::vec3> generateSpacedObjectPositions(int count, float range, float minDistance) {
-    std::vector<glm::vec3> positions;
-
-    // Random number generator for X and Z positions
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> dist(-range, range);
-
-    while (positions.size() < count) {
-        // Generate a new potential position
-        float xRNG = dist(gen);
-        float xSpan = xRNG + ((xRNG / abs(xRNG)) * 5.0); // stop spawning 5 units left and right of origin (car position)
-        float zRNG = dist(gen);
-        float zSpan = zRNG + ((zRNG / abs(zRNG)) * 3.0); // stop spawning 3 units left and right of origin (car position)
-        glm::vec3 newPosition(xSpan, 0.0f, zSpan);
-
-        // Check if the new position is valid (i.e., far enough from other positions)
-        if (isPositionValid(newPosition, positions, minDistance)) {
-            positions.push_back(newPosition);
-        }
+    std::vector<glm::vec3> positions = samplePoissonDisk(count, range, minDistance, placementRandom);
+    if (positions.size() < static_cast<size_t>(count)) {
+        std::cout << "Only room for " << positions.size() << " of " << count << " objects " << minDistance
+                  << " units apart in range " << range << std::endl;
     }
-
     return positions;
 }
 
@@ -185,13 +178,21 @@ std::vector<glm::vec3> generateBowlingPinPositions(glm::vec3 center) {
 // Declare the texture ID for the loading screen
 unsigned int loadingScreenTexture;
 
+// Time per frame the GL thread spends on asset uploads, while the menu is shown and once
+// the player is waiting for the game to start
+const double MENU_UPLOAD_BUDGET = 0.004;
+const double STARTING_UPLOAD_BUDGET = 0.030;
+
+// Where --profile=N writes its capture
+const char* PROFILE_PATH = "profile.json";
+
 // Function declarations
 void processMenuInput(GLFWwindow* window);
-void processEndGameInput(GLFWwindow* window, Car& car, std::vector<Cow_Character>& cows, std::vector<Giraffe_Character>& giraffes, Model& carModel, Model& cowModel, Model& giraffeModel);
-void renderLoadingScreen(unsigned int backgroundTexture, Shader& quadShader);
-void renderEndGameScreen(Shader& quadShader, TextRenderer& textRenderer, int gameScore);
-void renderQuad(float x, float y, float width, float height);
-void resetGame(Car& car, std::vector<Cow_Character>& cows, std::vector<Giraffe_Character>& giraffes, Model& carModel, Model& cowModel, Model& giraffeModel);
+void processEndGameInput(GLFWwindow* window, Car& car, CowSystem& cows, GiraffeSystem& giraffes, Model& carModel, Model& cowModel, Model& giraffeModel);
+void renderLoadingScreen(SpriteBatch& batch, unsigned int backgroundTexture);
+void renderLoadingProgress(SpriteBatch& batch, TextRenderer& textRenderer, float progress, const char* label);
+void renderEndGameScreen(SpriteBatch& batch, TextRenderer& textRenderer, int gameScore);
+void resetGame(Car& car, CowSystem& cows, GiraffeSystem& giraffes, Model& carModel, Model& cowModel, Model& giraffeModel);
 
 // Function: processMenuInput
 void processMenuInput(GLFWwindow* window) {
@@ -207,7 +208,7 @@ void processMenuInput(GLFWwindow* window) {
 }
 
 // Function to process input in the end game state
-void processEndGameInput(GLFWwindow* window, Car& car, std::vector<Cow_Character>& cows, std::vector<Giraffe_Character>& giraffes, Model& carModel, Model& cowModel, Model& giraffeModel) {
+void processEndGameInput(GLFWwindow* window, Car& car, CowSystem& cows, GiraffeSystem& giraffes, Model& carModel, Model& cowModel, Model& giraffeModel) {
     // Detect when the user clicks "PLAY AGAIN" and reset the game
     if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS) {
         double xpos, ypos;
@@ -224,53 +225,39 @@ void processEndGameInput(GLFWwindow* window, Car& car, std::vector<Cow_Character
 }
 
 // Function: renderLoadingScreen
-void renderLoadingScreen(unsigned int backgroundTexture, Shader& quadShader) {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-    // Disable depth testing so 2D elements are rendered on top
-    glDisable(GL_DEPTH_TEST);
-
-    // Set up orthographic projection for 2D rendering
-    glm::mat4 projection = glm::ortho(0.0f, 1024.0f, 0.0f, 768.0f);
-    quadShader.use();
-    quadShader.setMat4("projection", projection);
-
-    // Bind the background texture
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, backgroundTexture);
-    quadShader.setInt("texture1", 0);
+void renderLoadingScreen(SpriteBatch& batch, unsigned int backgroundTexture) {
+    // Full-screen background quad
+    batch.quad(backgroundTexture, 0.0f, 0.0f, 1024.0f, 768.0f);
+}
 
-    // Render the quad for the background
-    renderQuad(0.0f, 0.0f, 1024.0f, 768.0f); // Full-screen background quad
+// Function: renderLoadingProgress
+// Draws the asset loading bar and a label over the loading screen
+void renderLoadingProgress(SpriteBatch& batch, TextRenderer& textRenderer, float progress, const char* label) {
+    // Track, then the filled part on top of it
+    const float barX = 312.0f, barY = 60.0f, barWidth = 400.0f, barHeight = 10.0f;
+    batch.solid(barX, barY, barWidth, barHeight, glm::vec4(40.0f / 255.0f, 40.0f / 255.0f, 40.0f / 255.0f, 1.0f));
+    batch.solid(barX, barY, barWidth * glm::clamp(progress, 0.0f, 1.0f), barHeight, glm::vec4(1.0f));
 
-    // Re-enable depth testing
-    glEnable(GL_DEPTH_TEST);
+    batch.text(textRenderer, label, barX, barY + 20.0f, 0.6f, glm::vec3(1.0f));
 }
 
 // Function to render the end game screen
-void renderEndGameScreen(Shader& quadShader, TextRenderer& textRenderer, int gameScore) {
+void renderEndGameScreen(SpriteBatch& batch, TextRenderer& textRenderer, int gameScore) {
     // Set clear color to black
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // Disable depth testing so 2D elements are rendered on top
-    glDisable(GL_DEPTH_TEST);
-
-    // Set up orthographic projection for 2D rendering
-    glm::mat4 projection = glm::ortho(0.0f, 1024.0f, 0.0f, 768.0f);
-
     // Render "GAME OVER" text
-    textRenderer.SetProjection(projection);
     float gameOverScale = 2.0f;
     std::string gameOverText = "GAME OVER";
     float gameOverWidth = textRenderer.CalculateTextWidth(gameOverText, gameOverScale);
-    textRenderer.RenderText(gameOverText, 512.0f - gameOverWidth / 2.0f, 600.0f, gameOverScale, glm::vec3(1.0f));
+    batch.text(textRenderer, gameOverText.c_str(), 512.0f - gameOverWidth / 2.0f, 600.0f, gameOverScale, glm::vec3(1.0f));
 
     // Render "SCORE: X" text
     float scoreScale = 1.5f;
     std::string scoreText = "SCORE: " + std::to_string(gameScore);
     float scoreWidth = textRenderer.CalculateTextWidth(scoreText, scoreScale);
-    textRenderer.RenderText(scoreText, 512.0f - scoreWidth / 2.0f, 500.0f, scoreScale, glm::vec3(1.0f));
+    batch.text(textRenderer, scoreText.c_str(), 512.0f - scoreWidth / 2.0f, 500.0f, scoreScale, glm::vec3(1.0f));
 
     // Render "PLAY AGAIN" button as text
     float buttonScale = 1.5f;
@@ -286,54 +273,7 @@ void renderEndGameScreen(Shader& quadShader, TextRenderer& textRenderer, int gam
     playAgainButton.width = buttonWidth;
     playAgainButton.height = buttonHeight;
 
-    textRenderer.RenderText(buttonText, buttonX, buttonY, buttonScale, glm::vec3(1.0f));
-
-    // Re-enable depth testing
-    glEnable(GL_DEPTH_TEST);
-}
-
-// Function: renderQuad
-void renderQuad(float x, float y, float width, float height) {
-    float vertices[] = {
-        // Positions          // Texture Coords
-        x,          y + height,  0.0f, 1.0f, // Top-left
-        x,          y,           0.0f, 0.0f, // Bottom-left
-        x + width,  y,           1.0f, 0.0f, // Bottom-right
-
-        x,          y + height,  0.0f, 1.0f, // Top-left
-        x + width,  y,           1.0f, 0.0f, // Bottom-right
-        x + width,  y + height,  1.0f, 1.0f  // Top-right
-    };
-
-    // Setup VAO and VBO if not already done
-    static unsigned int quadVAO = 0, quadVBO;
-    if (quadVAO == 0) {
-        glGenVertexArrays(1, &quadVAO);
-        glGenBuffers(1, &quadVBO);
-        glBindVertexArray(quadVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_DYNAMIC_DRAW);
-
-        // Position attribute
-        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(0);
-
-        // Texture Coords attribute
-        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-        glEnableVertexAttribArray(1);
-    } else {
-        // Update vertex data
-        glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-    }
-
-    // Render the textured quad
-    glBindVertexArray(quadVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-
-    // Reset OpenGL states after rendering
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    batch.text(textRenderer, buttonText.c_str(), buttonX, buttonY, buttonScale, glm::vec3(1.0f));
 }
 
 // Hitbox for the walls around map
@@ -373,7 +313,7 @@ void initializeWallsFromGround(const Hitbox& groundHitbox) {
 }
 
 // Function to reset the game
-void resetGame(Car& car, std::vector<Cow_Character>& cows, std::vector<Giraffe_Character>& giraffes, Model& carModel, Model& cowModel, Model& giraffeModel) {
+void resetGame(Car& car, CowSystem& cows, GiraffeSystem& giraffes, Model& carModel, Model& cowModel, Model& giraffeModel) {
     // Reset game variables
     gameScore = 0;
     gameStartTime = glfwGetTime();
@@ -386,79 +326,47 @@ void resetGame(Car& car, std::vector<Cow_Character>& cows, std::vector<Giraffe_C
     car.reset();
     
     // Reset cows
-    std::vector<glm::vec3> cowPositions = generateSpacedObjectPositions(10, 90.0f, 5.0f);
-    for (size_t i = 0; i < cows.size(); ++i) {
-        cows[i].reset(cowPositions[i]);
-    }
+    std::vector<glm::vec3> cowPositions = generateSpacedObjectPositions(gameConfig.cowCount, gameConfig.animalRange, gameConfig.animalSpacing);
+    cows.reset(cowPositions);
 
     // Reset giraffes
-    std::vector<glm::vec3> positions = generateSpacedObjectPositions(20, 90.0f, 5.0f);
-    for (size_t i = 0; i < giraffes.size(); ++i) {
-        giraffes[i].reset(positions[i]);
-    }
+    std::vector<glm::vec3> positions = generateSpacedObjectPositions(gameConfig.giraffeCount, gameConfig.animalRange, gameConfig.animalSpacing);
+    giraffes.reset(positions);
 }
 
 // Main function
-int main() {
-    GLFWwindow* window = initializeWindow();
-    // tell stb_image.h to flip loaded texture's on the y-axis (before loading model).
-    stbi_set_flip_vertically_on_load(true);
-    // Create shader programs
-    Shader quadShader("src/shaders/quad_shader.vert", "src/shaders/quad_shader.frag");
-    Shader shaderProgram("src/shaders/vertex_shader.vert", "src/shaders/fragment_shader.frag");
-    Shader objectShader("src/shaders/obj_vertex_shader.vert", "src/shaders/obj_fragment_shader.frag");
-    //Shader objectShader2("src/shaders/obj_vertex_shader.vert", "src/shaders/obj_fragment_shader.frag");
-    Shader reflectionShader("src/shaders/reflection_vertex_shader.vert", "src/shaders/reflection_fragment_shader.frag");
-    Shader smokeShader("src/shaders/particle_vertex_shader.vert", "src/shaders/particle_fragment_shader.frag");
-    Shader textShader("src/shaders/text_shader.vert", "src/shaders/text_shader.frag");
-
-    // Load models
-    Model big_rock("src/models/big_rock.obj");
-    Model small_rock("src/models/small_rock.obj");
-    Model tree("src/models/tree.obj");
-    Model ground("src/models/ground.obj");
-    Model carModel("src/models/car.obj");
-    Model cowModel("src/models/cow.obj");
-    Model giraffeModel("src/models/new_giraffe.obj");
-    
-    // Create game objects
-    Hitbox groundHitbox = ground.calculateHitbox();
-    glm::vec3 groundMin = groundHitbox.minCorner;
-    glm::vec3 groundMax = groundHitbox.maxCorner;
+int main(int argc, char** argv) {
+    // Time every startup phase until the first frame is on screen
+    StartupReport startup;
 
-    Car car(carModel);
+    // Start the log writer before anything logs from a hot path
+    logStart();
+    PROFILE_THREAD("main");
 
-    std::vector<Cow_Character> cows;
-    for (const auto& position : generateSpacedObjectPositions(20, 70.0f, 5.0f)) {
-        cows.emplace_back(cowModel, position);  // This will use the move constructor
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));  // Wait for 100 milliseconds
+    // Counts, map size, tick rate and seed can be changed from the command line
+    if (!parseGameConfig(argc, argv, gameConfig)) {
+        std::cout << "Some options were not understood, see GameConfig.h" << std::endl;
     }
 
-    std::vector<Giraffe_Character> giraffes;
-    glm::vec3 center(0.0f, 0.0f, -20.0f);
-    for (const auto& position : generateSpacedObjectPositions(50, 70.0f, 5.0f)) {
-        giraffes.emplace_back(giraffeModel, position);  // This will use the move constructor
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));  // Wait for 100 milliseconds
-    }
+    // Master seed for every random stream, can be fixed with --seed=N to replay a run
+    uint64_t seed = gameConfig.hasSeed ? gameConfig.seed : makeTimeSeed();
+    setMasterSeed(seed);
+    placementRandom.reseed(deriveSeed(RANDOM_STREAM_PLACEMENT, 0));
+    std::cout << "Random seed: " << seed << " (run with --seed=" << seed << " to replay)" << std::endl;
 
-        // Particle system for smoke (position the exhaust pipe relatively to the car)
-    glm::vec3 exhaustOffset = glm::vec3(0.0f, 0.7f, 0.0f);  // GTA-style damage smoke
-    ExhaustSystem exhaustSystem(100, exhaustOffset);  // Max 100 particles
+    // With --check-allocations=1 a heap allocation in the warmed-up game loop aborts
+    setAllocationChecking(gameConfig.checkAllocations);
 
-    // Create camera object
-    Camera camera;
-
-    int treeCount = 10;
-    std::vector<glm::vec3> treePositions = generateSpacedObjectPositions(treeCount, 90.0f, 15.0f);  // Range -90 to 90, at least 5 units apart
-
-    int bigRockCount = 15;
-    std::vector<glm::vec3> bigRockPositions = generateSpacedObjectPositions(bigRockCount, 90.0f, 15.0f);
-
-    int smallRockCount = 30;
-    std::vector<glm::vec3> smallRockPositions = generateSpacedObjectPositions(smallRockCount, 90.0f, 15.0f);
+    GLFWwindow* window = initializeWindow();
+    gpuProfileInit();
+    // tell stb_image.h to flip loaded texture's on the y-axis (before loading model).
+    stbi_set_flip_vertically_on_load(true);
+    startup.phase("window");
 
-    // Hitboxes for collision detection
-    std::vector<Hitbox> environmentHitboxes;
+    // The menu is loaded up front, everything else streams in while it is shown
+    // Per-frame vertex data, three frames of 1 MB
+    StreamBuffer streamBuffer(GL_ARRAY_BUFFER, 3 * 1024 * 1024);
+    SpriteBatch spriteBatch(streamBuffer);
 
     std::cout << "Current Working Directory: " << std::filesystem::current_path() << std::endl;
 
@@ -473,22 +381,121 @@ int main() {
         std::cout << "Loading screen texture loaded successfully. ID: " << loadingScreenTexture << std::endl;
     }
 
-    // Initialize time variables
-    float lastTime = glfwGetTime();
+    // Initialise Text Renderer
+    TextRenderer textRenderer("src/fonts/arial.ttf", 30.0f);
+
+    // GL objects owned by main() are deleted here, before the window and its context go
+    auto shutdownGraphics = [&]() {
+        textRenderer.Shutdown();
+        spriteBatch.shutdown();
+        streamBuffer.shutdown();
+        gpuProfileShutdown();
+        glfwDestroyWindow(window);
+        glfwTerminate();
+    };
+
+    // Set up projection matrix for the menu, HUD and end game screens
+    glm::mat4 screenProjection = glm::ortho(0.0f, static_cast<float>(1024), 0.0f, static_cast<float>(768));
+    startup.phase("menu assets");
 
-    // Initialize the walls around the map
-    initializeWallsFromGround(groundHitbox);
+    // Filled in by the asset loader below
+    Shader shaderProgram;
+    Shader objectShader;
+    //Shader objectShader2("src/shaders/obj_vertex_shader.vert", "src/shaders/obj_fragment_shader.frag");
+    ShaderVariants reflectionShaders;  // Rocks, with and without the sky reflection
+    Shader smokeShader;
+    Model big_rock;
+    Model small_rock;
+    Model tree;
+    Model ground;
+    Model carModel;
+    Model cowModel;
+    Model giraffeModel;
+    Cubemap cubemap;
+    ImageData smokeImage;
+
+    // Herds are spawned in bulk, each with its own seed derived from the master seed
+    CowSystem cows(gameConfig.cowCount, streamSeed(RANDOM_STREAM_COWS));
+    GiraffeSystem giraffes(gameConfig.giraffeCount, streamSeed(RANDOM_STREAM_GIRAFFES));
+    std::vector<glm::vec3> treePositions;
+    std::vector<glm::vec3> bigRockPositions;
+    std::vector<glm::vec3> smallRockPositions;
+
+        // Particle system for smoke (position the exhaust pipe relatively to the car)
+    glm::vec3 exhaustOffset = glm::vec3(0.0f, 0.7f, 0.0f);  // GTA-style damage smoke
+    ExhaustSystem exhaustSystem(100, exhaustOffset);  // Max 100 particles
 
-    // Print the working directory
-    //std::cout << "Current Working Directory: " << std::filesystem::current_path() << std::endl;
+    CollisionWorld collisionWorld;
 
-    // Initialise Text Renderer
-    TextRenderer textRenderer("src/fonts/arial.ttf", textShader, 30.0f);
+    // Load graph. File reading, image decoding and model import run on loader threads,
+    // shader compiles and buffer and texture uploads run on this thread between frames.
+    AssetLoader loader;
+    auto addShader = [&](Shader& shader, const char* vertexPath, const char* fragmentPath) {
+        return loader.add(fragmentPath, LOAD_GROUP_GAMEPLAY,
+                          [&shader, vertexPath, fragmentPath]() { shader.load(vertexPath, fragmentPath); },
+                          [&shader]() { shader.compile(); });
+    };
+    auto addModel = [&](Model& model, const char* path) {
+        return loader.add(path, LOAD_GROUP_GAMEPLAY, [&model, path]() { model.loadModel(path); }, [&model]() { model.upload(); });
+    };
+
+    // Create shader programs
+    addShader(shaderProgram, "src/shaders/vertex_shader.vert", "src/shaders/fragment_shader.frag");
+    addShader(objectShader, "src/shaders/obj_vertex_shader.vert", "src/shaders/obj_fragment_shader.frag");
+    loader.add("src/shaders/reflection_fragment_shader.frag", LOAD_GROUP_GAMEPLAY, [&]() {
+        reflectionShaders.load("src/shaders/reflection_vertex_shader.vert", "src/shaders/reflection_fragment_shader.frag");
+    }, [&]() {
+        // Build both variants now, the game only looks them up
+        reflectionShaders.compile(SHADER_NONE);
+        reflectionShaders.compile(SHADER_CUBEMAP);
+    });
+    addShader(smokeShader, "src/shaders/particle_vertex_shader.vert", "src/shaders/particle_fragment_shader.frag");
 
-    // Set up projection matrix for text rendering
-    glm::mat4 textProjection = glm::ortho(0.0f, static_cast<float>(1024), 0.0f, static_cast<float>(768));
-    textRenderer.SetProjection(textProjection);
+    // Load models
+    int bigRockJob = addModel(big_rock, "src/models/big_rock.obj");
+    int smallRockJob = addModel(small_rock, "src/models/small_rock.obj");
+    addModel(tree, "src/models/tree.obj");
+    int groundJob = addModel(ground, "src/models/ground.obj");
+    addModel(carModel, "src/models/car.obj");
+    addModel(cowModel, "src/models/cow.obj");
+    addModel(giraffeModel, "src/models/new_giraffe.obj");
+
+    // One job draws every placement, so the placement stream is used in the same order each run
+    int placementJob = loader.add("placement", LOAD_GROUP_GAMEPLAY, [&]() {
+        cows.spawnMany(generateSpacedObjectPositions(gameConfig.cowCount, gameConfig.animalRange, gameConfig.animalSpacing));
+        giraffes.spawnMany(generateSpacedObjectPositions(gameConfig.giraffeCount, gameConfig.animalRange, gameConfig.animalSpacing));
+        treePositions = generateSpacedObjectPositions(gameConfig.treeCount, gameConfig.objectRange, gameConfig.objectSpacing);
+        bigRockPositions = generateSpacedObjectPositions(gameConfig.bigRockCount, gameConfig.objectRange, gameConfig.objectSpacing);
+        smallRockPositions = generateSpacedObjectPositions(gameConfig.smallRockCount, gameConfig.objectRange, gameConfig.objectSpacing);
+    });
+
+    // Build the static collision world once from the rock placements and the walls
+    loader.add("collision world", LOAD_GROUP_GAMEPLAY, [&]() {
+        // Initialize the walls around the map
+        // A stress map can be bigger than the ground model, keep the walls around the whole map
+        Hitbox playArea = ground.getLocalBounds();
+        if (gameConfig.isStress()) {
+            float mapEdge = std::max(gameConfig.animalRange, gameConfig.objectRange) + 10.0f;
+            playArea.minCorner = glm::min(playArea.minCorner, glm::vec3(-mapEdge, 0.0f, -mapEdge));
+            playArea.maxCorner = glm::max(playArea.maxCorner, glm::vec3(mapEdge, 0.0f, mapEdge));
+        }
+        initializeWallsFromGround(playArea);
 
+        Hitbox smallRockBounds = small_rock.getLocalBounds();
+        for (const auto& position : smallRockPositions) {
+            collisionWorld.addBox(Hitbox(smallRockBounds.minCorner + position, smallRockBounds.maxCorner + position), COLLISION_ROCK);
+        }
+        Hitbox bigRockBounds = big_rock.getLocalBounds();
+        for (const auto& position : bigRockPositions) {
+            collisionWorld.addBox(Hitbox(bigRockBounds.minCorner + position, bigRockBounds.maxCorner + position), COLLISION_ROCK);
+        }
+        for (const auto& wallHitbox : wallHitboxes) {
+            collisionWorld.addBox(wallHitbox, COLLISION_WALL);
+        }
+        collisionWorld.build();
+    }, nullptr, {placementJob, smallRockJob, bigRockJob, groundJob});
+
+    // The sky reflection and the smoke are not needed to start playing
     // load cubemap
     std::vector<std::string> faces
         {
@@ -499,17 +506,313 @@ int main() {
             "src/cubemap/lposy.png",   // Positive Z (front face)
             "src/cubemap/lposz.png"     // Negative Z (back face)
         };
-    Cubemap cubemap(faces);  // Load the cubemap
+    loader.add("src/cubemap", LOAD_GROUP_EFFECTS, [&]() { cubemap.loadFaces(faces); }, [&]() { cubemap.upload(); });
+    loader.add("src/smoke-img_trans.png", LOAD_GROUP_EFFECTS, [&]() { smokeImage = decodeImage("src/smoke-img_trans.png"); }, [&]() {
+        if (smokeImage.pixels) exhaustSystem.setTexture(uploadTexture(smokeImage, GL_CLAMP_TO_EDGE, GL_LINEAR));
+        freeImage(smokeImage);
+    });
+
+    // Leave a core for this thread and one for the system
+    unsigned int cores = std::thread::hardware_concurrency();
+    loader.start(cores > 3 ? std::min(cores - 2, 4u) : 1u);
+
+    // Stress mode skips the menu, which also puts the gameplay assets first
+    if (gameConfig.isStress()) {
+        currentState = STATE_GAME;
+    }
+
+    // Scratch memory for one frame, e.g. the HUD text
+    FrameArena frameArena;
+
+    // Show the menu while the game loads. Clicking Start moves the gameplay assets to the front
+    // of the queue and gives their uploads more of each frame, the game starts once they are in.
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+    bool firstFrameShown = false;
+    do {
+        glfwPollEvents();
+        frameArena.reset();
+        if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS || glfwWindowShouldClose(window)) {
+            logShutdown();
+            shutdownGraphics();
+            return 0;
+        }
+
+        processMenuInput(window);
+        if (currentState == STATE_GAME) {
+            loader.promote(LOAD_GROUP_GAMEPLAY);
+        }
+        loader.upload(currentState == STATE_GAME ? STARTING_UPLOAD_BUDGET : MENU_UPLOAD_BUDGET);
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        const char* label = currentState == STATE_GAME
+            ? frameArena.format("Starting game... %d%%", static_cast<int>(loader.progress() * 100.0f))
+            : frameArena.format("Loading %s", loader.currentName());
+        spriteBatch.begin(screenProjection);
+        renderLoadingScreen(spriteBatch, loadingScreenTexture);
+        renderLoadingProgress(spriteBatch, textRenderer, loader.progress(), label);
+        spriteBatch.end();
+        glfwSwapBuffers(window);
+        streamBuffer.endFrame();
+
+        // The first frame is on screen, the menu takes input from here on
+        if (!firstFrameShown) {
+            startup.phase("first frame");
+            firstFrameShown = true;
+        }
+    } while (!loader.done(LOAD_GROUP_GAMEPLAY));
+    startup.phase("gameplay assets");
+
+    // Create game objects
+    Hitbox groundHitbox = ground.getLocalBounds();
+    glm::vec3 groundMin = groundHitbox.minCorner;
+    glm::vec3 groundMax = groundHitbox.maxCorner;
+
+    Car car(carModel);
+
+    // Give the renderer a first snapshot of the herds
+    cows.capture();
+    giraffes.capture();
+    cows.publish();
+    giraffes.publish();
+
+    // Create camera object
+    Camera camera;
+
+    // Fixed simulation step, rendering interpolates between the last two ticks
+    FixedTimestep timestep(gameConfig.tickRate);
+
+    // Broadphase grids for the moving entities. Awake agents are rebuilt every tick,
+    // sleeping agents only when the set of sleepers changes.
+    SpatialHash cowGrid;
+    SpatialHash giraffeGrid;
+    SpatialHash sleepingCowGrid;
+    SpatialHash sleepingGiraffeGrid;
+    uint64_t sleepingCowVersion = UINT64_MAX;
+    uint64_t sleepingGiraffeVersion = UINT64_MAX;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> sleepingCandidates;
+
+    // Size everything the ticks fill up front, so the running game does not allocate
+    size_t agentCount = cows.size() + giraffes.size();
+    cowGrid.reserve(cows.size());
+    sleepingCowGrid.reserve(cows.size());
+    giraffeGrid.reserve(giraffes.size());
+    sleepingGiraffeGrid.reserve(giraffes.size());
+    candidates.reserve(agentCount);
+    sleepingCandidates.reserve(agentCount);
+
+    // Query the awake and the sleeping grid, the two never hold the same agent
+    auto queryAgents = [&](SpatialHash& awakeGrid, SpatialHash& sleepingGrid, const Hitbox& box) {
+        awakeGrid.query(box, candidates);
+        sleepingGrid.query(box, sleepingCandidates);
+        candidates.insert(candidates.end(), sleepingCandidates.begin(), sleepingCandidates.end());
+    };
+    startup.phase("entities");
+
+    // Startup is over once the game can be played
+    startup.print();
+    loader.printTimes();
+
+    // Initialize time variables
+    float lastTime = glfwGetTime();
+
+    // Result of one simulation step, handed back to the GL thread
+    struct SimulationResult {
+        int ticks = 0;
+        float tickDelta = 0.0f;
+        float alpha = 1.0f;
+        int score = 0;
+        double simulationTime = 0.0;  // Seconds spent simulating
+        size_t activeAgents = 0;      // Cows and giraffes awake after the last tick
+        size_t sleepingAgents = 0;
+    };
+    int simulationScore = 0;  // Score as the simulation sees it, shown once its step is presented
+
+    // Run the ticks for one frame, including collision and scoring, then capture the transforms
+    // into the back buffers. Touches no GL or GLFW input state, so it can run on a worker thread.
+    auto simulate = [&](float frameTime, CarInput input) {
+        PROFILE_ZONE("simulate");
+        SimulationResult result;
+        double start = glfwGetTime();
+
+        // Run the simulation in fixed ticks, whatever the frame rate is
+        result.ticks = timestep.advance(frameTime);
+        result.tickDelta = timestep.tickDelta();
+        float tickDelta = result.tickDelta;
+        for (int tick = 0; tick < result.ticks; tick++) {
+            {
+                PROFILE_ZONE("car update");
+                car.update(tickDelta, input, collisionWorld);
+            }
+
+            // Update every cow, large herds are split across worker threads
+            {
+                PROFILE_ZONE("cow update");
+                cows.update(tickDelta, collisionWorld);
+            }
+
+            // Update every giraffe
+            {
+                PROFILE_ZONE("giraffe update");
+                giraffes.update(tickDelta);
+            }
+
+            // Rebuild the broadphase grids from this tick's bounds
+            {
+                PROFILE_ZONE("grid rebuild");
+                cowGrid.build(cows.agents, cows.activity.awake());
+                giraffeGrid.build(giraffes.agents, giraffes.activity.awake());
+                if (cows.activity.sleepingVersion() != sleepingCowVersion) {
+                    sleepingCowGrid.build(cows.agents, cows.activity.sleeping());
+                    sleepingCowVersion = cows.activity.sleepingVersion();
+                }
+                if (giraffes.activity.sleepingVersion() != sleepingGiraffeVersion) {
+                    sleepingGiraffeGrid.build(giraffes.agents, giraffes.activity.sleeping());
+                    sleepingGiraffeVersion = giraffes.activity.sleepingVersion();
+                }
+            }
+
+            // Check for collisions between the car and the cows
+            {
+                PROFILE_ZONE("collision");
+
+                // Only cows sharing a cell with the car reach the narrow phase
+                queryAgents(cowGrid, sleepingCowGrid, car.getHitbox());
+                for (uint32_t i : candidates) {
+                    if (car.getHitbox().isColliding(cows.agents.getHitbox(i))) {
+                        // prevent multiple knockback force if there is still collision on next frames
+                        if (doOnce) {
+                            glm::vec3 hitDirection = cows.agents.getPosition(i) - car.getPosition();
+                            cows.gameHit(i, hitDirection, car.getSpeed());  // Pass car speed and direction to apply knockback
+                            car.gameHit();
+                        }
+                    }
+                }
+
+                // Check for collisions between cows that were hit and nearby giraffes.
+                // A sleeping cow stands still, so it cannot run into a giraffe.
+                for (uint32_t i : cows.activity.awake()) {
+                    if (!cows.getCowHit(i)) continue;
+
+                    Hitbox cowHitbox = cows.agents.getHitbox(i);
+                    queryAgents(giraffeGrid, sleepingGiraffeGrid, cowHitbox);
+                    for (uint32_t j : candidates) {
+                        if (cowHitbox.isColliding(giraffes.agents.getHitbox(j))) {
+                            glm::vec3 hitDirection = giraffes.agents.getPosition(j) - cows.agents.getPosition(i);
+                            giraffes.gameHit(j, hitDirection, cows.getSpeed(i), simulationScore);
+                        }
+                    }
+                }
+            }
+
+            // Advance the knockdown animation once per tick
+            giraffes.updateKnockdown(tickDelta);
+        }
+
+        // Fill the back buffers, the GL thread flips them when it picks up this result
+        if (result.ticks > 0) {
+            PROFILE_ZONE("capture");
+            car.capture();
+            cows.capture();
+            giraffes.capture();
+        }
+
+        result.alpha = timestep.alpha();
+        result.score = simulationScore;
+        result.activeAgents = cows.activeCount() + giraffes.activeCount();
+        result.sleepingAgents = cows.sleepingCount() + giraffes.sleepingCount();
+        result.simulationTime = glfwGetTime() - start;
+        return result;
+    };
+
+    SimulationResult shownSimulation;  // Step whose snapshot is on screen
+
+    // Pipelined mode runs every step on one long-lived worker, handing it the frame's input here
+    float pendingFrameTime = 0.0f;
+    CarInput pendingInput{};
+    SimulationResult pendingResult;
+    bool simulationPending = false;
+    WorkerThread simulationThread([&]() {
+        PROFILE_THREAD("simulation");
+        pendingResult = simulate(pendingFrameTime, pendingInput);
+    });
+
+    // Flip the snapshots of a finished step to the front. Only called while no step is running.
+    auto presentSimulation = [&](const SimulationResult& result) {
+        if (result.ticks > 0) {
+            car.publish();
+            cows.publish();
+            giraffes.publish();
+        }
+        gameScore = result.score;
+        shownSimulation = result;
+
+        // Smoke is only visual, it follows the published car on this thread
+        PROFILE_ZONE("particle update");
+        for (int tick = 0; tick < result.ticks; tick++) {
+            exhaustSystem.update(result.tickDelta, car.getRenderPosition(1.0f));
+        }
+    };
+
+    // Game frames played so far. The first ones may still grow buffers, later ones must not allocate.
+    const int ALLOCATION_WARMUP_FRAMES = 120;
+    int gameFrames = 0;
+
+    // --profile=N records N frames, starting when the allocation checks start
+    bool profileStarted = false;
+    int profileFramesLeft = 0;
+
+    // Stress mode skips the menu and reports where the frame time goes
+    uint64_t stressAllocations = allocationStats().count;
+    double stressSimTime = 0.0;
+    double stressRenderTime = 0.0;
+    int stressFrames = 0;
+    size_t stressStreamBytes = 0;
+    int stressStreamWaits = 0;
+    double stressReportTime = glfwGetTime();
+    if (gameConfig.isStress()) {
+        std::cout << "Stress mode: " << cows.size() << " cows, " << giraffes.size() << " giraffes, map range "
+                  << gameConfig.animalRange << std::endl;
+    }
+
+    PerfOverlay perfOverlay;
+    if (gameConfig.showOverlay) perfOverlay.toggle();
+    bool overlayKeyWasDown = false;
 
     // Main loop
     while (glfwGetKey(window, GLFW_KEY_ESCAPE) != GLFW_PRESS && !glfwWindowShouldClose(window)) {
-        
-        glfwPollEvents(); // Process events
+        // Write the capture out between frames, writing it allocates
+        if (profileStarted && profileFramesLeft == 0 && profileCapturing()) {
+            profileEndCapture(PROFILE_PATH);
+        }
+        PROFILE_ZONE("frame");
+
+        {
+            PROFILE_ZONE("poll");
+            glfwPollEvents(); // Process events
+        }
+        frameArena.reset();
+
+        // Effects still streaming in get a small slice of every frame
+        bool assetsLoading = !loader.done();
+        if (assetsLoading) {
+            PROFILE_ZONE("asset upload");
+            loader.upload(MENU_UPLOAD_BUDGET);
+        }
 
         float currentTime = glfwGetTime();
         float deltaTime = currentTime - lastTime;
         lastTime = currentTime;
 
+        // The overlay shows the GL work of the frame before this one
+        RenderStats lastFrameStats = renderStats;
+        renderStats = RenderStats();
+        perfOverlay.addFrame(deltaTime);
+
+        bool overlayKeyDown = glfwGetKey(window, GLFW_KEY_F3) == GLFW_PRESS;
+        if (overlayKeyDown && !overlayKeyWasDown) perfOverlay.toggle();
+        overlayKeyWasDown = overlayKeyDown;
+
         // Clear the screen
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -521,14 +824,31 @@ int main() {
             processMenuInput(window);
 
             // Render the loading screen with background image
-            renderLoadingScreen(loadingScreenTexture, quadShader);
+            spriteBatch.begin(screenProjection);
+            renderLoadingScreen(spriteBatch, loadingScreenTexture);
+            if (assetsLoading) {
+                renderLoadingProgress(spriteBatch, textRenderer, loader.progress(), frameArena.format("Loading %s", loader.currentName()));
+            }
+            spriteBatch.end();
         } else if (currentState == STATE_GAME) {
             if (!gameStarted) {
                 gameStartTime = glfwGetTime();
                 gameScore = 0;
+                simulationScore = 0;
                 gameStarted = true;
+                timestep.reset();
+                gameFrames = 0;
+            }
+
+            if (gameConfig.profileFrames > 0 && !profileStarted && gameFrames == ALLOCATION_WARMUP_FRAMES) {
+                profileBeginCapture();
+                profileStarted = true;
+                profileFramesLeft = gameConfig.profileFrames;
             }
 
+            // Checked with --check-allocations=1: nothing below may use the heap once warmed up
+            NoAllocationScope steadyState(gameFrames++ >= ALLOCATION_WARMUP_FRAMES);
+
             // Compute game time elapsed
             gameTimeElapsed = currentTime - gameStartTime;
 
@@ -539,9 +859,34 @@ int main() {
                 //std::cout << "Game over! Final Score: " << gameScore << std::endl;
             }
 
-            car.update(deltaTime, window, exhaustSystem, environmentHitboxes, wallHitboxes);
+            // Finish the simulation step started last frame and show its result
+            if (simulationPending) {
+                {
+                    PROFILE_ZONE("simulation wait");
+                    simulationThread.wait();
+                }
+                simulationPending = false;
+                presentSimulation(pendingResult);
+            }
+
+            // Start the next step. Pipelined, it runs on a worker while this frame renders,
+            // so the screen is one frame behind the simulation at most.
+            CarInput input = Car::readInput(window);
+            if (gameConfig.serialSimulation) {
+                presentSimulation(simulate(deltaTime, input));
+            } else {
+                pendingFrameTime = deltaTime;
+                pendingInput = input;
+                simulationThread.start();
+                simulationPending = true;
+            }
+
+            double renderStart = glfwGetTime();
+
+            // Render between the last two ticks so motion stays smooth
+            float alpha = shownSimulation.alpha;
 
-            camera.computeMatricesFromInputs(window, car.getPosition(), car.getForwardDirection());
+            camera.computeMatricesFromInputs(window, car.getRenderPosition(alpha), car.getRenderForwardDirection(alpha));
             
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -555,196 +900,144 @@ int main() {
             setLightingAndObjectProperties(objectShader);
 
 
-            cubemap.draw(objectShader);  // Draw the cubemap
-
-            // Draw the car model   
-            car.draw(objectShader);
-
-            // Draw the ground model
-            glm::mat4 groundModel = glm::mat4(1.0f);
-            groundModel = glm::translate(groundModel, glm::vec3(0.0f, 0.0f, 0.0f)); // Position of ground
-            objectShader.setMat4("model", groundModel);
-            objectShader.setMat4("view", view);
-            objectShader.setMat4("projection", projection);
-            ground.draw(objectShader); // Draw ground
-
-
-        //    // Update the cow's position
-        //     cow.moveRandomly(deltaTime, environmentHitboxes, wallHitboxes);  // Update position and movement logic
-            // Update the cow's position
-            //cow.moveRandomly(deltaTime, environmentHitboxes, wallHitboxes);  // Update position and movement logic
-
-        //     glm::mat4 cowModelMatrix = glm::mat4(1.0f);
-        //     cowModelMatrix = glm::translate(cowModelMatrix, cow.getPosition());
-        //     cowModelMatrix = glm::rotate(cowModelMatrix, glm::radians(cow.getTotalRotationAngle()), glm::vec3(0.0f, 1.0f, 0.0f));
-        //     cowModelMatrix = glm::scale(cowModelMatrix, glm::vec3(0.1f, 0.1f, 0.1f));
-
-        //     // Pass the updated matrices to the shader
-        //     objectShader.setMat4("model", cowModelMatrix);
-        //     objectShader.setMat4("view", view);
-        //     objectShader.setMat4("projection", projection);
-
-        //     // Render the cow
-        //     cow.draw(objectShader);
-
-            // Use a thread pool for cow updates
-            std::vector<std::future<void>> cowFutures;
-            
-            for (auto& cow : cows) {
-                cowFutures.push_back(std::async(std::launch::async, [&cow, deltaTime, &environmentHitboxes]() {
-                    cow.moveRandomly(deltaTime, environmentHitboxes, wallHitboxes);  // Update position and movement logic
-                }));
+            {
+                PROFILE_ZONE("sky draw");
+                GPU_PROFILE_ZONE("sky draw");
+                cubemap.draw(objectShader);  // Draw the cubemap
             }
 
-            // Wait for all cow to finish updating
-            for (auto& future : cowFutures) {
-                future.get();  // Ensure all updates are complete
+            // Draw the car model   
+            {
+                PROFILE_ZONE("car draw");
+                GPU_PROFILE_ZONE("car draw");
+                car.draw(objectShader, alpha);
             }
 
-            // Render the cow after movement updates
-            for (auto& cow : cows) {
-                glm::mat4 cowModelMatrix = glm::mat4(1.0f);
-                cowModelMatrix = glm::translate(cowModelMatrix, cow.getPosition());
-                cowModelMatrix = glm::rotate(cowModelMatrix, glm::radians(cow.getTotalRotationAngle()), glm::vec3(0.0f, 1.0f, 0.0f));
-                cowModelMatrix = glm::scale(cowModelMatrix, glm::vec3(0.1f, 0.1f, 0.1f));
-
-                objectShader.setMat4("model", cowModelMatrix);
+            // Draw the ground model
+            {
+                PROFILE_ZONE("ground draw");
+                GPU_PROFILE_ZONE("ground draw");
+                glm::mat4 groundModel = glm::mat4(1.0f);
+                groundModel = glm::translate(groundModel, glm::vec3(0.0f, 0.0f, 0.0f)); // Position of ground
+                objectShader.setMat4("model", groundModel);
                 objectShader.setMat4("view", view);
                 objectShader.setMat4("projection", projection);
-                cow.draw(objectShader);
+                ground.draw(objectShader); // Draw ground
             }
 
-            // Use a thread pool for giraffe updates
-            std::vector<std::future<void>> giraffeFutures;
-            
-            for (auto& giraffe : giraffes) {
-                giraffeFutures.push_back(std::async(std::launch::async, [&giraffe, deltaTime]() {
-                    giraffe.moveRandomly(deltaTime);
-                }));
+            // Render the cows and giraffes
+            {
+                PROFILE_ZONE("cow draw");
+                GPU_PROFILE_ZONE("cow draw");
+                cows.draw(objectShader, cowModel, view, projection, alpha);
             }
-
-            // Wait for all giraffes to finish updating
-            for (auto& future : giraffeFutures) {
-                future.get();  // Ensure all updates are complete
-            }
-            
-            //objectShader2.use();
-            // Render the giraffes after movement updates
-            for (auto& giraffe : giraffes) {
-                glm::mat4 giraffeModelMatrix = glm::mat4(1.0f);
-                giraffeModelMatrix = glm::translate(giraffeModelMatrix, giraffe.getPosition());
-                giraffeModelMatrix = glm::rotate(giraffeModelMatrix, glm::radians(giraffe.getTotalRotationAngle()), glm::vec3(0.0f, 1.0f, 0.0f));
-                giraffeModelMatrix = glm::scale(giraffeModelMatrix, glm::vec3(0.2f, 0.2f, 0.2f));
-
-                objectShader.setMat4("model", giraffeModelMatrix);
-                objectShader.setMat4("view", view);
-                objectShader.setMat4("projection", projection);
-                giraffe.draw(objectShader);
+            {
+                PROFILE_ZONE("giraffe draw");
+                GPU_PROFILE_ZONE("giraffe draw");
+                giraffes.draw(objectShader, giraffeModel, view, projection, alpha);
             }
 
+            // The reflective variant only once the sky has streamed in
+            unsigned int skyTexture = cubemap.getTextureID();  // 0 until it has loaded
+            Shader& reflectionShader = reflectionShaders.get(skyTexture != 0u ? SHADER_CUBEMAP : SHADER_NONE);
             reflectionShader.use();
             setLightingAndObjectProperties(reflectionShader);
 
             // Draw the rocks
-            for (const auto& position : smallRockPositions) {
-                Hitbox smallRockHitBox = small_rock.calculateHitbox();
-                smallRockHitBox.minCorner += position;
-                smallRockHitBox.maxCorner += position;
-                // Check if this hitbox already exists in environmentHitboxes
-                bool isUnique = std::none_of(environmentHitboxes.begin(), environmentHitboxes.end(),
-                                            [&](const Hitbox& hitbox) {
-                                                return hitbox == smallRockHitBox;
-                                            });
-
-                if (isUnique) {
-                    environmentHitboxes.push_back(smallRockHitBox);
-                }
-
-                glm::mat4 smallRockkModel = glm::mat4(1.0f);
-                smallRockkModel = glm::translate(smallRockkModel, position); // Use fixed position
-                smallRockkModel = glm::scale(smallRockkModel, glm::vec3(3.5f, 3.5f, 3.5f)); // Scale trees if necessary
+            {
+                PROFILE_ZONE("rock draw");
+                GPU_PROFILE_ZONE("rock draw");
+                for (const auto& position : smallRockPositions) {
+                    glm::mat4 smallRockkModel = glm::mat4(1.0f);
+                    smallRockkModel = glm::translate(smallRockkModel, position); // Use fixed position
+                    smallRockkModel = glm::scale(smallRockkModel, glm::vec3(3.5f, 3.5f, 3.5f)); // Scale trees if necessary
                 
-                reflectionShader.setMat4("model", smallRockkModel);
-                reflectionShader.setMat4("view", view);
-                reflectionShader.setMat4("projection", projection);
-                reflectionShader.setVec3("cameraPos", camera.position);
-                small_rock.draw(reflectionShader, cubemap.getTextureID()); // Draw small rocks
-            }
-
-            for (const auto& position : bigRockPositions) {
-                Hitbox bigRockHitBox = big_rock.calculateHitbox();
-                bigRockHitBox.minCorner += position;
-                bigRockHitBox.maxCorner += position;
-                // Check if this hitbox already exists in environmentHitboxes
-                bool isUnique = std::none_of(environmentHitboxes.begin(), environmentHitboxes.end(),
-                                            [&](const Hitbox& hitbox) {
-                                                return hitbox == bigRockHitBox;
-                                            });
-
-                if (isUnique) {
-                    environmentHitboxes.push_back(bigRockHitBox);
+                    reflectionShader.setMat4("model", smallRockkModel);
+                    reflectionShader.setMat4("view", view);
+                    reflectionShader.setMat4("projection", projection);
+                    reflectionShader.setVec3("cameraPos", camera.position);
+                    small_rock.draw(reflectionShader, skyTexture); // Draw small rocks
                 }
 
-
-                glm::mat4 bigRockkModel = glm::mat4(1.0f);
-                bigRockkModel = glm::translate(bigRockkModel, position); // Use fixed position
-                bigRockkModel = glm::scale(bigRockkModel, glm::vec3(1.5f, 1.5f, 1.5f)); // Scale trees if necessary
+                for (const auto& position : bigRockPositions) {
+                    glm::mat4 bigRockkModel = glm::mat4(1.0f);
+                    bigRockkModel = glm::translate(bigRockkModel, position); // Use fixed position
+                    bigRockkModel = glm::scale(bigRockkModel, glm::vec3(1.5f, 1.5f, 1.5f)); // Scale trees if necessary
                 
-                reflectionShader.setMat4("model", bigRockkModel);
-                reflectionShader.setMat4("view", view);
-                reflectionShader.setMat4("projection", projection);
-                reflectionShader.setVec3("cameraPos", camera.position);
-                big_rock.draw(reflectionShader, cubemap.getTextureID()); // Draw big rocks
+                    reflectionShader.setMat4("model", bigRockkModel);
+                    reflectionShader.setMat4("view", view);
+                    reflectionShader.setMat4("projection", projection);
+                    reflectionShader.setVec3("cameraPos", camera.position);
+                    big_rock.draw(reflectionShader, skyTexture); // Draw big rocks
+                }
             }
 
             // Render smoke particles
-            exhaustSystem.render(smokeShader, view, projection);
+            {
+                PROFILE_ZONE("particle render");
+                GPU_PROFILE_ZONE("particle render");
+                exhaustSystem.render(smokeShader, view, projection);
+            }
 
-            // Check for collisions between the car and the cows
-            for (auto& cow : cows) {
-                if (car.getHitbox().isColliding(cow.getHitbox())) {
-                    // prevent multiple knockback force if there is still collision on next frames
-                    if (doOnce) {
-                        glm::vec3 hitDirection = cow.getPosition() - car.getPosition();
-                        cow.gameHit(hitDirection, car.getSpeed());  // Pass car speed and direction to apply knockback
-                        car.gameHit();
-                    }
-                }
+            {
+                PROFILE_ZONE("text");
+                GPU_PROFILE_ZONE("text");
 
-                for (auto& giraffe : giraffes) {
-                    if (cow.getHitbox().isColliding(giraffe.getHitbox()) && cow.getCowHit()) {
-                        glm::vec3 hitDirection = giraffe.getPosition() - cow.getPosition();
-                        giraffe.gameHit(hitDirection, cow.getSpeed(), deltaTime, gameScore);
+                // Render the score at the top left
+                spriteBatch.begin(screenProjection);
+                const char* scoreText = frameArena.format("SCORE: %d", gameScore);
+                spriteBatch.text(textRenderer, scoreText, 25.0f, 725.0f, 1.0f, glm::vec3(1.0f, 1.0f, 1.0f)); // White color
 
-                        // // Score one point for each giraffe hit by a cow
-                        // gameScore++;
-                        //std::cout << "Giraffe hit! Current Score: " << gameScore << std::endl;
-                    }
-                    giraffe.update(deltaTime);
-                }
+                // Render the remaining time at the top right
+                const char* timeText = frameArena.format("TIME: %.2f", 120.0f - gameTimeElapsed);
+                spriteBatch.text(textRenderer, timeText, 875.0f, 725.0f, 1.0f, glm::vec3(1.0f, 1.0f, 1.0f)); // White color
+                spriteBatch.end();
+            }
 
+            if (perfOverlay.isVisible()) {
+                PROFILE_ZONE("perf overlay");
+                PerfCounters counters;
+                counters.render = lastFrameStats;
+                counters.particles = exhaustSystem.liveParticles();
+                counters.activeAgents = shownSimulation.activeAgents;
+                counters.agents = cows.size() + giraffes.size();
+                counters.gpuMilliseconds = gpuProfileFrameMilliseconds();
+                perfOverlay.draw(spriteBatch, textRenderer, frameArena, screenProjection, counters);
             }
 
-            // Check for collisions between the car and the environment
-            for (const auto& hitbox : environmentHitboxes) {
-                if (car.getHitbox().isColliding(hitbox)) {
-                    //std::cout << "Car and environment collided!" << std::endl;
+            if (gameConfig.isStress()) {
+                // Average the simulation and render cost over two seconds
+                double frameEnd = glfwGetTime();
+                stressSimTime += shownSimulation.simulationTime;
+                stressRenderTime += frameEnd - renderStart;
+                stressFrames++;
+                stressStreamBytes += streamBuffer.frameBytes();
+                stressStreamWaits += streamBuffer.frameWaits();
+                if (frameEnd - stressReportTime >= 2.0) {
+                    uint64_t allocations = allocationStats().count;
+                    LOG_INFO("Stress {} agents: sim {} ms, render {} ms, {} fps, {} active, {} sleeping, {} allocations/frame",
+                             cows.size() + giraffes.size(), 1000.0 * stressSimTime / stressFrames,
+                             1000.0 * stressRenderTime / stressFrames, stressFrames / (frameEnd - stressReportTime),
+                             shownSimulation.activeAgents, shownSimulation.sleepingAgents,
+                             double(allocations - stressAllocations) / stressFrames);
+                    LOG_INFO("Stress streaming: {} KB/frame, {} waits for the GPU",
+                             stressStreamBytes / 1024.0 / stressFrames, stressStreamWaits);
+                    stressAllocations = allocations;
+                    stressStreamBytes = 0;
+                    stressStreamWaits = 0;
+                    stressSimTime = 0.0;
+                    stressRenderTime = 0.0;
+                    stressFrames = 0;
+                    stressReportTime = frameEnd;
                 }
             }
 
-            // Render smoke particles
-            exhaustSystem.render(smokeShader, view, projection);
-
-            // Render the score at the top left
-            std::string scoreText = "SCORE: " + std::to_string(gameScore);
-            textRenderer.RenderText(scoreText, 25.0f, 725.0f, 1.0f, glm::vec3(1.0f, 1.0f, 1.0f)); // White color
-
-            // Render the remaining time at the top right
-            std::stringstream stream;
-            stream << std::fixed << std::setprecision(2) << (120.0f - gameTimeElapsed);
-            std::string timeText = "TIME: " + stream.str();
-            textRenderer.RenderText(timeText, 875.0f, 725.0f, 1.0f, glm::vec3(1.0f, 1.0f, 1.0f)); // White color
-
+            // Leaving the game: let the running step finish before anything resets the world
+            if (currentState != STATE_GAME && simulationPending) {
+                simulationThread.wait();
+                simulationPending = false;
+                presentSimulation(pendingResult);
+            }
         } else if (currentState == STATE_END_GAME) {
             // Show the cursor in the end game menu
             glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
@@ -753,14 +1046,26 @@ int main() {
             processEndGameInput(window, car, cows, giraffes, carModel, cowModel, giraffeModel);
 
             // Render the end game screen
-            renderEndGameScreen(quadShader, textRenderer, gameScore);
+            spriteBatch.begin(screenProjection);
+            renderEndGameScreen(spriteBatch, textRenderer, gameScore);
+            spriteBatch.end();
         }
 
-        glfwSwapBuffers(window);
+        {
+            PROFILE_ZONE("swap");
+            glfwSwapBuffers(window);
+        }
+        streamBuffer.endFrame();
+        gpuProfileEndFrame();
+        if (profileFramesLeft > 0) profileFramesLeft--;
     }
 
+    // Wait for a step still running on a worker before the world is destroyed
+    simulationThread.wait();
+    if (profileCapturing()) profileEndCapture(PROFILE_PATH);
+
     // Cleanup
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    logShutdown();
+    shutdownGraphics();
     return 0;
 }
@@ -1,4 +1,8 @@
 #include "mesh.hpp"
+#include "ShaderVariants.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 
 Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures, Material material)
 {
@@ -6,8 +10,41 @@ Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std:
     this->indices = indices;
     this->textures = textures;
     this->material = material;
+    this->indexCount = static_cast<unsigned int>(indices.size());
 
+    calculateBounds();
+    buildSamplerNames();
+}
+
+// Create the GL buffers, on the GL thread. The mesh itself can be built on any thread.
+void Mesh::upload() {
     setupMesh();
+
+    // The GPU keeps its own copy, so the vertex data does not need to stay resident
+    std::vector<Vertex>().swap(vertices);
+    std::vector<unsigned int>().swap(indices);
+}
+
+// Compute the local box and bounding sphere of the mesh
+void Mesh::calculateBounds() {
+    if (vertices.empty()) return;
+
+    glm::vec3 minCorner(FLT_MAX, FLT_MAX, FLT_MAX);
+    glm::vec3 maxCorner(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (const auto& vertex : vertices) {
+        minCorner = glm::min(minCorner, vertex.Position);
+        maxCorner = glm::max(maxCorner, vertex.Position);
+    }
+    bounds = Hitbox(minCorner, maxCorner);
+
+    // Sphere around the box centre that reaches the furthest vertex
+    sphere.center = (minCorner + maxCorner) * 0.5f;
+    float radiusSquared = 0.0f;
+    for (const auto& vertex : vertices) {
+        glm::vec3 offset = vertex.Position - sphere.center;
+        radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+    }
+    sphere.radius = std::sqrt(radiusSquared);
 }
 
 void Mesh::setupMesh() {
@@ -38,79 +75,50 @@ void Mesh::setupMesh() {
     glBindVertexArray(0);
 }
 
-void Mesh::Draw(Shader &shader, unsigned int cubemapTextureID, bool usePBR) 
-{
-    if (usePBR) {
-        // PBR-specific texture binding
-        unsigned int albedoNr = 1;
-        unsigned int normalNr = 1;
-        unsigned int metallicNr = 1;
-        unsigned int roughnessNr = 1;
-        unsigned int aoNr = 1;
-
-        for(unsigned int i = 0; i < textures.size(); i++)
-        {
-            glActiveTexture(GL_TEXTURE0 + i); // Activate proper texture unit before binding
-
-            std::string number;
-            std::string name = textures[i].type;
-
-            if (name == "texture_albedo")
-                number = std::to_string(albedoNr++);
-            else if (name == "texture_normal")
-                number = std::to_string(normalNr++);
-            else if (name == "texture_metallic")
-                number = std::to_string(metallicNr++);
-            else if (name == "texture_roughness")
-                number = std::to_string(roughnessNr++);
-            else if (name == "texture_ao")
-                number = std::to_string(aoNr++);
-
-            shader.setInt(("material." + name + number).c_str(), i);
-            glBindTexture(GL_TEXTURE_2D, textures[i].id);
-        }
-    } else {
-        // Non-PBR texture handling
-        unsigned int diffuseNr = 1;
-        unsigned int specularNr = 1;
-
-        for(unsigned int i = 0; i < textures.size(); i++)
-        {
-            glActiveTexture(GL_TEXTURE0 + i); // Activate proper texture unit before binding
-
-            std::string number;
-            std::string name = textures[i].type;
-
-            if (name == "texture_diffuse")
-                number = std::to_string(diffuseNr++);
-            else if (name == "texture_specular")
-                number = std::to_string(specularNr++);
+// Uniform name of every texture, "material.<type><n>" where n counts the textures of a type.
+// Types the basic shaders do not number get no suffix, as the draw code always did.
+void Mesh::buildSamplerNames() {
+    static const char* basicTypes[] = {"texture_diffuse", "texture_specular"};
 
-            shader.setInt(("material." + name + number).c_str(), i);
-            glBindTexture(GL_TEXTURE_2D, textures[i].id);
+    std::vector<unsigned int> counters(2, 1);
+    for (const Texture& texture : textures) {
+        std::string number;
+        for (size_t t = 0; t < 2; t++) {
+            if (texture.type == basicTypes[t]) number = std::to_string(counters[t]++);
         }
+        samplerNames.push_back("material." + texture.type + number);
+    }
+}
 
-        // Set material properties for non-PBR
-        shader.setVec3("material.ambient", material.ambient);
-        shader.setVec3("material.diffuse", material.diffuse);
-        shader.setVec3("material.specular", material.specular);
-        shader.setFloat("material.shininess", material.shininess);
+void Mesh::Draw(Shader &shader, unsigned int cubemapTextureID) 
+{
+    // Sampler names were built once in buildSamplerNames, nothing is formatted per draw
+    for(unsigned int i = 0; i < textures.size(); i++)
+    {
+        glActiveTexture(GL_TEXTURE0 + i); // Activate proper texture unit before binding
+        shader.setInt(samplerNames[i].c_str(), i);
+        glBindTexture(GL_TEXTURE_2D, textures[i].id);
     }
+    renderStats.textureBinds += textures.size();
+
+    // Set material properties
+    shader.setVec3("material.ambient", material.ambient);
+    shader.setVec3("material.diffuse", material.diffuse);
+    shader.setVec3("material.specular", material.specular);
+    shader.setFloat("material.shininess", material.shininess);
 
-    // Set cubemap texture if it exists
-    if (cubemapTextureID != -1) {
-        shader.setInt("cubemapTexture", textures.size()); // Bind to the next available texture unit
-        shader.setBool("useCubemap", true);
-        glActiveTexture(GL_TEXTURE0 + textures.size());
+    // Bind the cubemap for the reflective variant, whose sampler already points at this unit
+    if (cubemapTextureID != 0) {
+        glActiveTexture(GL_TEXTURE0 + CUBEMAP_TEXTURE_UNIT);
         glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTextureID);
-    } else {
-        shader.setBool("useCubemap", false);
+        renderStats.textureBinds++;
     }
 
     glActiveTexture(GL_TEXTURE0); // Reset active texture unit
 
     // Draw mesh
     glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+    renderStats.addDraw(indexCount / 3);
     glBindVertexArray(0);
 }
@@ -11,23 +11,40 @@
 #include "globals.hpp"
 #include "texture.hpp"
 #include "material.hpp"
+#include "hitbox.hpp"
+
+// Sphere enclosing a mesh or model in its local space
+struct BoundingSphere {
+    glm::vec3 center = glm::vec3(0.0f);
+    float radius = 0.0f;
+};
 
 class Mesh {
 public:
-    // Mesh data
+    // Mesh data, vertices and indices are released once they are uploaded to the GPU
     std::vector<Vertex> vertices;           // Ensure to use std::vector
     std::vector<unsigned int> indices;      // Ensure to use std::vector
     std::vector<Texture> textures;           // Ensure to use std::vector
     Material material;
+    unsigned int indexCount;
+
+    // Local bounds, computed once from the vertices when the mesh is imported
+    Hitbox bounds;
+    BoundingSphere sphere;
     
     Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures, Material material);
-    void Draw(Shader &shader, unsigned int cubemapTextureID = -1, bool usePBR = false);
+    void upload();
+    // cubemapTextureID 0 draws without the sky cubemap
+    void Draw(Shader &shader, unsigned int cubemapTextureID = 0);
 
 private:
     // Render data
     unsigned int VAO, VBO, EBO;
+    std::vector<std::string> samplerNames;     // Uniform name of every texture
 
+    void calculateBounds();
     void setupMesh();
+    void buildSamplerNames();
 };  
 
 #endif
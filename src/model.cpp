@@ -17,6 +17,31 @@ void Model::loadModel(std::string const &path){
 
     // process ASSIMP's root node recursively
     processNode(scene->mRootNode, scene);
+
+    // cache the bounds now, the vertex data is released after upload
+    calculateBounds();
+}
+
+// Create the GL objects for everything loadModel read
+void Model::upload() {
+    for (Mesh& mesh : meshes) {
+        mesh.upload();
+    }
+
+    // Give every texture that uses a decoded image its GL id
+    for (PendingTexture& pending : pendingTextures) {
+        unsigned int id = pending.image.pixels ? uploadTexture(pending.image, GL_REPEAT, GL_LINEAR_MIPMAP_LINEAR) : 0;
+        freeImage(pending.image);
+        for (Texture& texture : textures_loaded) {
+            if (texture.path == pending.path) texture.id = id;
+        }
+        for (Mesh& mesh : meshes) {
+            for (Texture& texture : mesh.textures) {
+                if (texture.path == pending.path) texture.id = id;
+            }
+        }
+    }
+    pendingTextures.clear();
 }
 
 void Model::processNode(aiNode *node, const aiScene *scene){
@@ -133,45 +158,12 @@ Mesh Model:: processMesh(aiMesh *mesh, const aiScene *scene){
     return Mesh(vertices, indices, textures, mat);
 }
 
+// Draw every mesh once. The program passed in is the variant for the features in use,
+// i.e. built with USE_CUBEMAP when a cubemap is given.
 void Model::draw(Shader& shader, unsigned int cubemapTextureID) {
-    for (unsigned int i = 0; i < meshes.size(); i++) {
-        meshes[i].Draw(shader, cubemapTextureID);
-        // Bind PBR Textures
-        for (unsigned int j = 0; j < meshes[i].textures.size(); j++) {
-            glActiveTexture(GL_TEXTURE0 + j); // Activate the texture unit
-            std::string name = meshes[i].textures[j].type;
-
-            // use specific names for PBR textures
-            if (name == "texture_albedo") {
-                shader.setInt("albedoMap", j); // Corresponds to GL_TEXTURE0 + j
-                //std::cout << "Albedo map set\n";
-
-            } else if (name == "texture_normal") {
-                shader.setInt("normalMap", j); // Corresponds to GL_TEXTURE0 + j
-                //std::cout << "normal map set\n";
-
-            } else if (name == "texture_metallic") {
-                shader.setInt("metallicMap", j); // Corresponds to GL_TEXTURE0 + j
-                //std::cout << "mettallic map set\n";
-
-            } else if (name == "texture_roughness") {
-                shader.setInt("roughnessMap", j); // Corresponds to GL_TEXTURE0 + j
-                //std::cout << "roughness map set\n";
-
-            } else if (name == "texture_ao") {
-                shader.setInt("aoMap", j); // Corresponds to GL_TEXTURE0 + j
-                //std::cout << "ao map set\n";
-            }
-
-            glBindTexture(GL_TEXTURE_2D, meshes[i].textures[j].id);
-        }
-
-        // Draw the mesh with the currently bound textures
-        meshes[i].Draw(shader);
+    for (Mesh& mesh : meshes) {
+        mesh.Draw(shader, cubemapTextureID);
     }
-
-    // Unbind textures after drawing
-    glActiveTexture(GL_TEXTURE0);
 }
 
 
@@ -194,8 +186,13 @@ std::vector<Texture> Model::loadMaterialTextures(aiMaterial *mat, aiTextureType
         }
         if(!skip)
         {   // if texture hasn't been loaded already, load it
+            // Only decode here, the GL texture is made in upload()
             Texture texture;
-            texture.id = TextureFromFile(str.C_Str(), this->directory);
+            texture.id = 0;
+            pendingTextures.push_back(PendingTexture{str.C_Str(), decodeImage(directory + '/' + str.C_Str())});
+            if (!pendingTextures.back().image.pixels) {
+                std::cout << "Texture failed to load at path: " << str.C_Str() << std::endl;
+            }
             texture.type = typeName;
             texture.path = str.C_Str();
             textures.push_back(texture);
@@ -265,24 +262,23 @@ unsigned int TextureFromFile(const char *path, const std::string &directory, boo
     return textureID;
 }
 
-// Calculate the hitbox for the model
-Hitbox Model::calculateHitbox() const {
+// Combine the bounds of every mesh into the bounds of the model
+void Model::calculateBounds() {
+    if (meshes.empty()) return;
+
     glm::vec3 minCorner(FLT_MAX, FLT_MAX, FLT_MAX);
     glm::vec3 maxCorner(-FLT_MAX, -FLT_MAX, -FLT_MAX);
-
     for (const auto& mesh : meshes) {
-
-        for (const auto& vertex : mesh.vertices) {
-            
-            minCorner.x = std::min(minCorner.x, vertex.Position.x);
-            minCorner.y = std::min(minCorner.y, vertex.Position.y);
-            minCorner.z = std::min(minCorner.z, vertex.Position.z);
-
-            maxCorner.x = std::max(maxCorner.x, vertex.Position.x);
-            maxCorner.y = std::max(maxCorner.y, vertex.Position.y);
-            maxCorner.z = std::max(maxCorner.z, vertex.Position.z);
-        }
+        minCorner = glm::min(minCorner, mesh.bounds.minCorner);
+        maxCorner = glm::max(maxCorner, mesh.bounds.maxCorner);
     }
+    localBounds = Hitbox(minCorner, maxCorner);
 
-    return Hitbox(minCorner, maxCorner);
-}
\ No newline at end of file
+    // Sphere around the box centre that encloses every mesh sphere
+    boundingSphere.center = (minCorner + maxCorner) * 0.5f;
+    boundingSphere.radius = 0.0f;
+    for (const auto& mesh : meshes) {
+        float reach = glm::length(mesh.sphere.center - boundingSphere.center) + mesh.sphere.radius;
+        boundingSphere.radius = std::max(boundingSphere.radius, reach);
+    }
+}
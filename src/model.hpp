@@ -26,23 +26,41 @@
 #include "material.hpp"
 #include "vertex.hpp"
 #include "hitbox.hpp"
+#include "texture_loader.h"
 
 class Model {
 public:
+    Model() = default;
     Model(std::string const &path, bool gamma = false) : gammaCorrection(gamma) {
         loadModel(path);
+        upload();
     }
-    void draw(Shader& shader, unsigned int cubemapTextureID = -1);
+    // Loading is split in two: loadModel imports the file and decodes its textures on any
+    // thread, upload creates the GL buffers and textures on the GL thread
+    void loadModel(const std::string& path);
+    void upload();
+    void draw(Shader& shader, unsigned int cubemapTextureID = 0);  // 0: no sky cubemap
     std::vector<Texture> textures_loaded; 
     std::vector<Mesh> meshes;
     std::string directory;
-    bool gammaCorrection;
+    bool gammaCorrection = false;
 
-    // Hitbox for collision detection
-    Hitbox calculateHitbox() const;
+    // Local bounds of all meshes, cached at import so they cost nothing to query
+    const Hitbox& getLocalBounds() const { return localBounds; }
+    const BoundingSphere& getBoundingSphere() const { return boundingSphere; }
     
 private:
-    void loadModel(const std::string& path);
+    Hitbox localBounds;
+    BoundingSphere boundingSphere;
+
+    // Textures decoded by loadModel, waiting for upload
+    struct PendingTexture {
+        std::string path;
+        ImageData image;
+    };
+    std::vector<PendingTexture> pendingTextures;
+
+    void calculateBounds();
     void processNode(aiNode* node, const aiScene* scene);
     Mesh processMesh(aiMesh* mesh, const aiScene* scene);
     std::vector<Texture> loadMaterialTextures(aiMaterial *mat, aiTextureType type, std::string typeName);
@@ -9,56 +9,54 @@
 #include <sstream>
 #include <iostream>
 
+#include "RenderStats.h"
+
 class Shader
 {
 public:
     unsigned int ID;
+    Shader() : ID(0) {}
     // constructor generates the shader on the fly
     // ------------------------------------------------------------------------
-    Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr)
+    Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr) : ID(0)
     {
-        // 1. retrieve the vertex/fragment source code from filePath
-        std::string vertexCode;
-        std::string fragmentCode;
-        std::string geometryCode;
-        std::ifstream vShaderFile;
-        std::ifstream fShaderFile;
-        std::ifstream gShaderFile;
-        // ensure ifstream objects can throw exceptions:
-        vShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-        fShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-        gShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-        try 
-        {
-            // open files
-            vShaderFile.open(vertexPath);
-            fShaderFile.open(fragmentPath);
-            std::stringstream vShaderStream, fShaderStream;
-            // read file's buffer contents into streams
-            vShaderStream << vShaderFile.rdbuf();
-            fShaderStream << fShaderFile.rdbuf();		
-            // close file handlers
-            vShaderFile.close();
-            fShaderFile.close();
-            // convert stream into string
-            vertexCode = vShaderStream.str();
-            fragmentCode = fShaderStream.str();			
-            // if geometry shader path is present, also load a geometry shader
-            if(geometryPath != nullptr)
-            {
-                gShaderFile.open(geometryPath);
-                std::stringstream gShaderStream;
-                gShaderStream << gShaderFile.rdbuf();
-                gShaderFile.close();
-                geometryCode = gShaderStream.str();
-            }
-        }
-        catch (std::ifstream::failure& e)
-        {
-            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
-        }
-        const char* vShaderCode = vertexCode.c_str();
-        const char * fShaderCode = fragmentCode.c_str();
+        load(vertexPath, fragmentPath, geometryPath);
+        compile();
+    }
+    // Loading is split in two so the files can be read on a loader thread and compiled later
+    // on the GL thread. load() only touches the disk, compile() only the GL context.
+    // ------------------------------------------------------------------------
+    void load(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr)
+    {
+        // 1. retrieve the vertex/fragment source code from filePath, with includes expanded
+        vertexCode = readSource(vertexPath);
+        fragmentCode = readSource(fragmentPath);
+        // if geometry shader path is present, also load a geometry shader
+        if(geometryPath != nullptr)
+            geometryCode = readSource(geometryPath);
+    }
+    // ------------------------------------------------------------------------
+    void compile()
+    {
+        compileSources(vertexCode, fragmentCode, geometryCode);
+
+        // the sources are not needed once the program is linked
+        std::string().swap(vertexCode);
+        std::string().swap(fragmentCode);
+        std::string().swap(geometryCode);
+    }
+    // Compile sources already in memory. 'defines' is pasted in after the #version line,
+    // which is how one source is built into several specialised programs.
+    // ------------------------------------------------------------------------
+    void compileSources(const std::string& vertexSource, const std::string& fragmentSource,
+                        const std::string& geometrySource = "", const std::string& defines = "")
+    {
+        std::string vertexText = withDefines(vertexSource, defines);
+        std::string fragmentText = withDefines(fragmentSource, defines);
+        std::string geometryText = withDefines(geometrySource, defines);
+        bool hasGeometry = !geometrySource.empty();
+        const char* vShaderCode = vertexText.c_str();
+        const char * fShaderCode = fragmentText.c_str();
         // 2. compile shaders
         unsigned int vertex, fragment;
         // vertex shader
@@ -73,9 +71,9 @@ public:
         checkCompileErrors(fragment, "FRAGMENT");
         // if geometry shader is given, compile geometry shader
         unsigned int geometry;
-        if(geometryPath != nullptr)
+        if(hasGeometry)
         {
-            const char * gShaderCode = geometryCode.c_str();
+            const char * gShaderCode = geometryText.c_str();
             geometry = glCreateShader(GL_GEOMETRY_SHADER);
             glShaderSource(geometry, 1, &gShaderCode, NULL);
             glCompileShader(geometry);
@@ -85,83 +83,135 @@ public:
         ID = glCreateProgram();
         glAttachShader(ID, vertex);
         glAttachShader(ID, fragment);
-        if(geometryPath != nullptr)
+        if(hasGeometry)
             glAttachShader(ID, geometry);
         glLinkProgram(ID);
         checkCompileErrors(ID, "PROGRAM");
         // delete the shaders as they're linked into our program now and no longer necessary
         glDeleteShader(vertex);
         glDeleteShader(fragment);
-        if(geometryPath != nullptr)
+        if(hasGeometry)
             glDeleteShader(geometry);
-
+    }
+    // Read a shader file and replace every '#include "file"' line with that file, so shaders
+    // can share declarations. Included paths are relative to the including file.
+    // ------------------------------------------------------------------------
+    static std::string readSource(const std::string& path, int depth = 0)
+    {
+        std::ifstream file(path);
+        if(!file.is_open())
+        {
+            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << path << std::endl;
+            return "";
+        }
+        std::string directory = path.substr(0, path.find_last_of('/') + 1);
+        std::string source;
+        std::string line;
+        while(std::getline(file, line))
+        {
+            size_t start = line.find_first_not_of(" \t");
+            if(start != std::string::npos && line.compare(start, 8, "#include") == 0)
+            {
+                size_t open = line.find('"', start);
+                size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+                if(close == std::string::npos || depth >= 8)
+                    std::cout << "ERROR::SHADER::BAD_INCLUDE in " << path << ": " << line << std::endl;
+                else
+                    source += readSource(directory + line.substr(open + 1, close - open - 1), depth + 1);
+                continue;
+            }
+            source += line;
+            source += '\n';
+        }
+        return source;
     }
     // activate the shader
     // ------------------------------------------------------------------------
     void use() 
     { 
         glUseProgram(ID); 
+        renderStats.programBinds++;
     }
     // utility uniform functions
+    // Names are plain C strings, so setting a uniform by literal never builds a std::string
     // ------------------------------------------------------------------------
-    void setBool(const std::string &name, bool value) const
+    void setBool(const char* name, bool value) const
     {         
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value); 
+        glUniform1i(glGetUniformLocation(ID, name), (int)value); 
     }
     // ------------------------------------------------------------------------
-    void setInt(const std::string &name, int value) const
+    void setInt(const char* name, int value) const
     { 
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value); 
+        glUniform1i(glGetUniformLocation(ID, name), value); 
     }
     // ------------------------------------------------------------------------
-    void setFloat(const std::string &name, float value) const
+    void setFloat(const char* name, float value) const
     { 
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value); 
+        glUniform1f(glGetUniformLocation(ID, name), value); 
     }
     // ------------------------------------------------------------------------
-    void setVec2(const std::string &name, const glm::vec2 &value) const
+    void setVec2(const char* name, const glm::vec2 &value) const
     { 
-        glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        glUniform2fv(glGetUniformLocation(ID, name), 1, &value[0]); 
     }
-    void setVec2(const std::string &name, float x, float y) const
+    void setVec2(const char* name, float x, float y) const
     { 
-        glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y); 
+        glUniform2f(glGetUniformLocation(ID, name), x, y); 
     }
     // ------------------------------------------------------------------------
-    void setVec3(const std::string &name, const glm::vec3 &value) const
+    void setVec3(const char* name, const glm::vec3 &value) const
     { 
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        glUniform3fv(glGetUniformLocation(ID, name), 1, &value[0]); 
     }
-    void setVec3(const std::string &name, float x, float y, float z) const
+    void setVec3(const char* name, float x, float y, float z) const
     { 
-        glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z); 
+        glUniform3f(glGetUniformLocation(ID, name), x, y, z); 
     }
     // ------------------------------------------------------------------------
-    void setVec4(const std::string &name, const glm::vec4 &value) const
+    void setVec4(const char* name, const glm::vec4 &value) const
     { 
-        glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        glUniform4fv(glGetUniformLocation(ID, name), 1, &value[0]); 
     }
-    void setVec4(const std::string &name, float x, float y, float z, float w) 
+    void setVec4(const char* name, float x, float y, float z, float w) 
     { 
-        glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w); 
+        glUniform4f(glGetUniformLocation(ID, name), x, y, z, w); 
     }
     // ------------------------------------------------------------------------
-    void setMat2(const std::string &name, const glm::mat2 &mat) const
+    void setMat2(const char* name, const glm::mat2 &mat) const
     {
-        glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix2fv(glGetUniformLocation(ID, name), 1, GL_FALSE, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
-    void setMat3(const std::string &name, const glm::mat3 &mat) const
+    void setMat3(const char* name, const glm::mat3 &mat) const
     {
-        glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix3fv(glGetUniformLocation(ID, name), 1, GL_FALSE, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
-    void setMat4(const std::string &name, const glm::mat4 &mat) const
+    void setMat4(const char* name, const glm::mat4 &mat) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix4fv(glGetUniformLocation(ID, name), 1, GL_FALSE, &mat[0][0]);
     }
 
 private:
+    // Insert lines right after #version, which has to stay the first statement
+    static std::string withDefines(const std::string& source, const std::string& defines)
+    {
+        if(defines.empty() || source.empty())
+            return source;
+        size_t version = source.find("#version");
+        if(version == std::string::npos)
+            return defines + source;
+        size_t lineEnd = source.find('\n', version);
+        if(lineEnd == std::string::npos)
+            return source + "\n" + defines;
+        return source.substr(0, lineEnd + 1) + defines + source.substr(lineEnd + 1);
+    }
+
+    // Sources read by load() and waiting for compile()
+    std::string vertexCode;
+    std::string fragmentCode;
+    std::string geometryCode;
+
     // utility function for checking shader compilation/linking errors.
     // ------------------------------------------------------------------------
     void checkCompileErrors(GLuint shader, std::string type)
@@ -0,0 +1,7 @@
+// Basic material, set per mesh by Mesh::Draw
+struct Material {
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+    float shininess;
+};
@@ -3,12 +3,7 @@ out vec4 FragColor;
 
 in vec2 TexCoords;
 
-struct Material {
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-    float shininess;
-};
+#include "material.glsl"
 
 uniform Material material;
 uniform sampler2D texture_diffuse1;
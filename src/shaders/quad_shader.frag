@@ -1,9 +0,0 @@
-#version 330 core
-in vec2 TexCoords;
-out vec4 FragColor;
-
-uniform sampler2D texture1;
-
-void main() {
-    FragColor = texture(texture1, TexCoords);
-}
\ No newline at end of file
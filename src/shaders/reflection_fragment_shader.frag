@@ -5,18 +5,14 @@ in vec2 TexCoords;
 in vec3 WorldPos;
 in vec3 Normal;
 
-struct Material {
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-    float shininess;
-};
+#include "material.glsl"
 
 uniform Material material;
 uniform sampler2D texture_diffuse1;
-uniform samplerCube cubemapTexture;
 uniform vec3 cameraPos;  // Pass the camera position to the fragment shader
-uniform bool useCubemap; // Flag to determine if the cubemap is used
+#ifdef USE_CUBEMAP
+uniform samplerCube cubemapTexture;  // Only in the USE_CUBEMAP variant
+#endif
 
 void main()
 {
@@ -25,11 +21,11 @@ void main()
 
     // Calculate reflection if cubemap is given
     vec3 reflectedColor = vec3(0.0); // Initialize to black (no reflection)
-    if (useCubemap) {
-        vec3 viewDir = normalize(cameraPos - WorldPos);
-        vec3 reflectDir = reflect(-viewDir, normalize(Normal));
-        reflectedColor = texture(cubemapTexture, reflectDir).rgb;
-    }
+#ifdef USE_CUBEMAP
+    vec3 viewDir = normalize(cameraPos - WorldPos);
+    vec3 reflectDir = reflect(-viewDir, normalize(Normal));
+    reflectedColor = texture(cubemapTexture, reflectDir).rgb;
+#endif
 
     // Mix diffuse and reflected colors based on reflectiveness (you can adjust this blending factor)
     float reflectivity = 0.5;  // You can set this based on material properties if needed
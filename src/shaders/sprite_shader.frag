@@ -0,0 +1,19 @@
+#version 330 core
+in vec2 TexCoords;
+in vec4 Color;
+flat in float DistanceField;
+out vec4 FragColor;
+
+uniform sampler2D image;  // Glyph atlas for text, 0.5 is the glyph edge
+
+void main() {
+    vec4 texel = texture(image, TexCoords);
+    if (DistanceField > 0.5) {
+        // Smooth the edge over about one screen pixel, whatever scale the text is drawn at
+        float edgeWidth = fwidth(texel.r);
+        float alpha = smoothstep(0.5 - edgeWidth, 0.5 + edgeWidth, texel.r);
+        FragColor = vec4(Color.rgb, Color.a * alpha);
+    } else {
+        FragColor = texel * Color;
+    }
+}
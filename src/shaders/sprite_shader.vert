@@ -0,0 +1,18 @@
+#version 330 core
+layout(location = 0) in vec2 aPos;
+layout(location = 1) in vec2 aTexCoords;
+layout(location = 2) in vec4 aColor;
+layout(location = 3) in float aDistanceField;  // 1 for text
+
+out vec2 TexCoords;
+out vec4 Color;
+flat out float DistanceField;
+
+uniform mat4 projection;
+
+void main() {
+    TexCoords = aTexCoords;
+    Color = aColor;
+    DistanceField = aDistanceField;
+    gl_Position = projection * vec4(aPos, 0.0, 1.0);
+}
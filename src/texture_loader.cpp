@@ -26,44 +26,64 @@
 #include <iostream>
 
 unsigned int loadTexture(const std::string& path) {
-    unsigned int texture;
-    glGenTextures(1, &texture);
-
-    int width, height, nrChannels;
-    stbi_set_flip_vertically_on_load(true); // Flip image vertically if needed
-    unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
-    if (data) {
-        GLenum format = GL_RGB;
-        if (nrChannels == 4)
-            format = GL_RGBA;
-        else if (nrChannels == 3)
-            format = GL_RGB;
-        else if (nrChannels == 1)
-            format = GL_RED;
-        else {
-            // Handle other formats if necessary
-        }
-
-        glBindTexture(GL_TEXTURE_2D, texture);
-
-        // Load the texture data
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-
-        // Generate mipmaps if needed
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        // Set texture parameters
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);	
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);	
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);	
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        stbi_image_free(data);
-    } else {
+    ImageData image = decodeImage(path);
+    if (!image.pixels) {
         //std::cout << "Failed to load texture: " << path << std::endl;
-        stbi_image_free(data);
         return 0;
     }
+    unsigned int texture = uploadTexture(image, GL_CLAMP_TO_EDGE, GL_LINEAR);
+    freeImage(image);
+    return texture;
+}
+
+ImageData decodeImage(const std::string& path) {
+    // The flip flag is per thread, loader threads must not race on the global one
+    stbi_set_flip_vertically_on_load_thread(true);
+
+    ImageData image;
+    image.pixels = stbi_load(path.c_str(), &image.width, &image.height, &image.channels, 0);
+    return image;
+}
+
+void freeImage(ImageData& image) {
+    stbi_image_free(image.pixels);
+    image.pixels = nullptr;
+}
+
+unsigned int uploadTexture(const ImageData& image, GLint wrap, GLint minFilter) {
+    GLenum format = GL_RGB;
+    if (image.channels == 4)
+        format = GL_RGBA;
+    else if (image.channels == 3)
+        format = GL_RGB;
+    else if (image.channels == 1)
+        format = GL_RED;
+    else {
+        // Handle other formats if necessary
+    }
+
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    // Set texture parameters
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
     return texture;
-}
\ No newline at end of file
+}
+
+unsigned int loadColorTexture(unsigned char r, unsigned char g, unsigned char b) {
+    unsigned char pixel[4] = {r, g, b, 255};
+    ImageData image;
+    image.pixels = pixel;
+    image.width = 1;
+    image.height = 1;
+    image.channels = 4;
+    return uploadTexture(image, GL_CLAMP_TO_EDGE, GL_LINEAR);
+}
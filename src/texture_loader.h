@@ -12,4 +12,20 @@
 
 unsigned int loadTexture(const std::string& path);
 
+// Pixels decoded by stb_image, kept on the CPU until they are uploaded
+struct ImageData {
+    unsigned char* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+};
+
+// Decode an image flipped for OpenGL. Touches no GL state, so it can run on a loader thread.
+ImageData decodeImage(const std::string& path);
+void freeImage(ImageData& image);
+// Create a mipmapped texture from decoded pixels, on the GL thread
+unsigned int uploadTexture(const ImageData& image, GLint wrap, GLint minFilter);
+// 1x1 texture of a single colour, for flat quads
+unsigned int loadColorTexture(unsigned char r, unsigned char g, unsigned char b);
+
 #endif
\ No newline at end of file
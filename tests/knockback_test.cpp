@@ -0,0 +1,54 @@
+// knockback_test.cpp
+// Knocks cows around a wall and checks the swept knockback lets them leave a wall they
+// touch but still stops them at one they are thrown into.
+// Not part of the game build, compile it on its own from the repository root, e.g.
+//   g++ -std=c++17 -Idependencies/include -Isrc tests/knockback_test.cpp src/CowSystem.cpp src/EntityStore.cpp src/AgentDraw.cpp
+//       src/AgentActivity.cpp src/CollisionWorld.cpp src/BoxBatch.cpp src/hitbox.cpp src/ParallelFor.cpp
+//       src/Random.cpp src/Log.cpp src/Profiler.cpp src/AllocationTracker.cpp src/glad.c -pthread -o knockback_test
+
+#include <cstdio>
+#include "CowSystem.h"
+
+// The test never draws, this keeps model.cpp and Assimp out of the link
+void Model::draw(Shader&, unsigned int) {}
+
+static const float TICK = 1.0f / 60.0f;
+static int failures = 0;
+
+static void check(bool condition, const char* what) {
+    std::printf("%s: %s\n", condition ? "ok  " : "FAIL", what);
+    if (!condition) failures++;
+}
+
+int main() {
+    // A wall along the left edge of the map, like initializeWallsFromGround builds
+    CollisionWorld world;
+    world.addBox(Hitbox(glm::vec3(-50.0f, 0.0f, -50.0f), glm::vec3(-49.0f, 5.0f, 50.0f)), COLLISION_WALL);
+    world.build();
+
+    // Where the wall bounce in moveRandomly leaves a cow: its hitbox exactly touching the wall
+    float touching = -49.0f + 1.0f;
+    CowSystem cows(2, 1234);
+    cows.spawn(glm::vec3(touching, 0.0f, 0.0f));
+    cows.spawn(glm::vec3(touching + 5.0f, 0.0f, 10.0f));
+
+    // Cow 0 is knocked away from the wall, cow 1 into it
+    cows.gameHit(0, glm::vec3(1.0f, 0.0f, 0.0f), 4.0f);
+    cows.gameHit(1, glm::vec3(-1.0f, 0.0f, 0.0f), 4.0f);
+    for (int step = 0; step < 60; step++) cows.update(TICK, world);
+
+    float awayX = cows.agents.posX[0];
+    float intoX = cows.agents.posX[1];
+    check(awayX > touching + 1.0f, "a cow touching the wall is knocked away from it");
+    check(intoX >= touching && intoX < touching + 0.1f, "a cow knocked into the wall stops at it");
+
+    // The sweep itself: leaving a touched box is free, moving into it is a hit at once
+    Hitbox box(glm::vec3(touching - 1.0f, 0.0f, -1.0f), glm::vec3(touching + 1.0f, 2.0f, 1.0f));
+    SegmentHit hit;
+    check(!world.sweepBox(box, glm::vec3(2.0f, 0.0f, 0.0f), COLLISION_ALL, hit), "sweeping away from a touched wall misses");
+    check(world.sweepBox(box, glm::vec3(-2.0f, 0.0f, 0.0f), COLLISION_ALL, hit) && hit.time == 0.0f && hit.normal.x > 0.0f,
+          "sweeping into a touched wall hits it at the start");
+
+    if (failures > 0) std::printf("%d checks failed\n", failures);
+    return failures > 0 ? 1 : 0;
+}